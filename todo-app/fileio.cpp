@@ -0,0 +1,257 @@
+#include "fileio.h"
+#include "taskmetrics.h"
+
+#include <atomic>
+#include <iostream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace MyLibrary
+{
+    MappedFile::~MappedFile() {
+        close();
+    }
+
+#ifdef _WIN32
+    bool MappedFile::open(const std::string& path) {
+        close();
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE) return false;
+
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize)) {
+            CloseHandle(file);
+            return false;
+        }
+        fileHandle = file;
+        length = static_cast<size_t>(fileSize.QuadPart);
+        if (length == 0) return true;  // nothing to map
+
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping) {
+            close();
+            return false;
+        }
+        mappingHandle = mapping;
+        ptr = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        if (!ptr) {
+            close();
+            return false;
+        }
+        TODO_COUNT(METRIC_BYTES_READ, length);
+        return true;
+    }
+
+    void MappedFile::close() {
+        if (ptr) UnmapViewOfFile(ptr);
+        if (mappingHandle) CloseHandle(static_cast<HANDLE>(mappingHandle));
+        if (fileHandle) CloseHandle(static_cast<HANDLE>(fileHandle));
+        ptr = nullptr;
+        length = 0;
+        mappingHandle = nullptr;
+        fileHandle = nullptr;
+    }
+#else
+    bool MappedFile::open(const std::string& path) {
+        close();
+        fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            close();
+            return false;
+        }
+        length = static_cast<size_t>(st.st_size);
+        if (length == 0) return true;  // mmap rejects zero-length mappings
+
+        void* mapped = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped == MAP_FAILED) {
+            close();
+            return false;
+        }
+        madvise(mapped, length, MADV_SEQUENTIAL);
+        ptr = static_cast<const char*>(mapped);
+        TODO_COUNT(METRIC_BYTES_READ, length);
+        return true;
+    }
+
+    void MappedFile::close() {
+        if (ptr) munmap(const_cast<char*>(ptr), length);
+        if (fd >= 0) ::close(fd);
+        ptr = nullptr;
+        length = 0;
+        fd = -1;
+    }
+#endif
+
+    bool syncFile(std::FILE* file) {
+        if (std::fflush(file) != 0) return false;
+        TODO_COUNT(METRIC_FILE_SYNCS, 1);
+#ifdef _WIN32
+        return _commit(_fileno(file)) == 0;
+#else
+        return fsync(fileno(file)) == 0;
+#endif
+    }
+
+    bool replaceFile(const std::string& from, const std::string& to) {
+#ifdef _WIN32
+        return MoveFileExA(from.c_str(), to.c_str(),
+            MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+        return std::rename(from.c_str(), to.c_str()) == 0;
+#endif
+    }
+
+    AtomicFileWriter::~AtomicFileWriter() {
+        abort();
+    }
+
+    bool AtomicFileWriter::open(const std::string& path) {
+        abort();
+        target = path;
+        // Numbered so two writers of the same file never share a temp file
+        static std::atomic<unsigned> writers{ 0 };
+        temp = path + "." + std::to_string(++writers) + ".tmp";
+        failed = false;
+        file = std::fopen(temp.c_str(), "wb");
+        if (!file) return false;
+        // Large stdio buffer so rows reach the OS in big sequential writes
+        std::setvbuf(file, nullptr, _IOFBF, 1 << 20);
+        return true;
+    }
+
+    void AtomicFileWriter::write(const char* data, size_t size) {
+        if (!file || failed) return;
+        if (std::fwrite(data, 1, size, file) != size) failed = true;
+        TODO_COUNT(METRIC_BYTES_WRITTEN, size);
+    }
+
+    bool AtomicFileWriter::commit() {
+        if (!file) return false;
+        bool ok = !failed && syncFile(file);
+        ok = std::fclose(file) == 0 && ok;
+        file = nullptr;
+        if (!ok || !replaceFile(temp, target)) {
+            std::remove(temp.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    void AtomicFileWriter::abort() {
+        if (!file) return;
+        std::fclose(file);
+        file = nullptr;
+        std::remove(temp.c_str());
+    }
+
+    bool writeFileAtomically(const std::string& path, const char* data, size_t size) {
+        AtomicFileWriter writer;
+        if (!writer.open(path)) return false;
+        writer.write(data, size);
+        return writer.commit();
+    }
+
+    /*--------------------- GROUP COMMIT ----------------------------------*/
+
+    GroupCommitWriter::~GroupCommitWriter() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        if (worker.joinable()) worker.join();
+    }
+
+    void GroupCommitWriter::setInterval(std::chrono::milliseconds interval) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            commitInterval = interval;
+        }
+        wake.notify_all();
+    }
+
+    std::chrono::milliseconds GroupCommitWriter::interval() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return commitInterval;
+    }
+
+    std::shared_future<bool> GroupCommitWriter::submit(const std::string& path, std::string data) {
+        std::shared_future<bool> result;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            PendingWrite& entry = pending[path];
+            entry.data = std::move(data);
+            // Saves merged into one write share its outcome
+            if (!entry.done) {
+                entry.done = std::make_shared<std::promise<bool>>();
+                entry.result = entry.done->get_future().share();
+            }
+            result = entry.result;
+            if (!worker.joinable()) worker = std::thread(&GroupCommitWriter::run, this);
+        }
+        wake.notify_all();
+        return result;
+    }
+
+    bool GroupCommitWriter::flush() {
+        std::unique_lock<std::mutex> lock(mutex);
+        flushRequested = true;
+        wake.notify_all();
+        idle.wait(lock, [this] { return pending.empty() && !writing; });
+        flushRequested = false;
+        bool ok = !failed;
+        failed = false;
+        return ok;
+    }
+
+    void GroupCommitWriter::run() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            wake.wait(lock, [this] { return stopping || !pending.empty(); });
+            if (pending.empty()) break;  // stopping with nothing left to write
+
+            // Let more saves pile up until the interval since the last
+            // commit has passed, unless someone is waiting on us.
+            wake.wait_until(lock, lastCommit + commitInterval,
+                [this] { return stopping || flushRequested; });
+
+            std::map<std::string, PendingWrite> batch;
+            batch.swap(pending);
+            writing = true;
+            lock.unlock();
+
+            bool ok = true;
+            for (auto& entry : batch) {
+                const std::string& data = entry.second.data;
+                bool written = writeFileAtomically(entry.first, data.data(), data.size());
+                if (!written) {
+                    std::cerr << "Error: Unable to save " << entry.first << ".\n";
+                    ok = false;
+                }
+                entry.second.done->set_value(written);
+            }
+
+            lock.lock();
+            writing = false;
+            if (!ok) failed = true;
+            lastCommit = std::chrono::steady_clock::now();
+            idle.notify_all();
+        }
+        idle.notify_all();
+    }
+
+} // end namespace MyLibrary
@@ -0,0 +1,137 @@
+#pragma once
+#ifndef FILEIO_H
+#define FILEIO_H
+
+#include <string>
+#include <string_view>
+#include <cstddef>
+#include <cstdio>
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace MyLibrary
+{
+    /**
+     * Read-only memory mapping of a whole file.
+     * Uses CreateFileMapping on Windows and mmap elsewhere; the mapping is
+     * released when the object goes out of scope.
+     */
+    class MappedFile {
+    public:
+        MappedFile() = default;
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        // Returns false if the file does not exist or cannot be mapped.
+        bool open(const std::string& path);
+        void close();
+
+        const char* data() const { return ptr; }
+        size_t size() const { return length; }
+        std::string_view view() const { return std::string_view(ptr, length); }
+
+    private:
+        const char* ptr = nullptr;
+        size_t length = 0;
+#ifdef _WIN32
+        void* fileHandle = nullptr;
+        void* mappingHandle = nullptr;
+#else
+        int fd = -1;
+#endif
+    };
+
+    // Flush stdio buffers and force the file's contents to disk.
+    bool syncFile(std::FILE* file);
+
+    // Rename from over to, replacing to if it already exists.
+    bool replaceFile(const std::string& from, const std::string& to);
+
+    /**
+     * Replaces a file without ever exposing a half-written version.
+     * Data goes to a temp file next to path, numbered per writer so
+     * concurrent saves of one file cannot mix; commit() fsyncs it once and
+     * renames it over path. If commit() is never reached the temp file is
+     * discarded.
+     */
+    class AtomicFileWriter {
+    public:
+        AtomicFileWriter() = default;
+        ~AtomicFileWriter();
+
+        AtomicFileWriter(const AtomicFileWriter&) = delete;
+        AtomicFileWriter& operator=(const AtomicFileWriter&) = delete;
+
+        bool open(const std::string& path);
+        void write(const char* data, size_t size);
+        void write(std::string_view data) { write(data.data(), data.size()); }
+        // Returns false if any write, the fsync or the rename failed.
+        bool commit();
+        void abort();
+
+    private:
+        std::FILE* file = nullptr;
+        std::string target;
+        std::string temp;
+        bool failed = false;
+    };
+
+    // One-shot AtomicFileWriter for data already in memory.
+    bool writeFileAtomically(const std::string& path, const char* data, size_t size);
+
+    /**
+     * Background writer that merges bursts of saves into one durable write.
+     * A file is committed at most once per interval; if it is submitted again
+     * before its turn, only the newest contents are written.
+     */
+    class GroupCommitWriter {
+    public:
+        GroupCommitWriter() = default;
+        // Writes anything still pending before returning
+        ~GroupCommitWriter();
+
+        GroupCommitWriter(const GroupCommitWriter&) = delete;
+        GroupCommitWriter& operator=(const GroupCommitWriter&) = delete;
+
+        void setInterval(std::chrono::milliseconds interval);
+        std::chrono::milliseconds interval() const;
+
+        // Queue data for path. The future reports whether it (or newer
+        // contents submitted for the same path before its turn) was committed.
+        std::shared_future<bool> submit(const std::string& path, std::string data);
+        // Commit everything submitted so far without waiting for the interval.
+        // Returns false if any write since the last flush failed.
+        bool flush();
+
+    private:
+        struct PendingWrite {
+            std::string data;
+            std::shared_ptr<std::promise<bool>> done;
+            std::shared_future<bool> result;
+        };
+
+        void run();
+
+        mutable std::mutex mutex;
+        std::condition_variable wake;
+        std::condition_variable idle;
+        std::map<std::string, PendingWrite> pending;
+        std::thread worker;
+        std::chrono::milliseconds commitInterval{ 0 };
+        std::chrono::steady_clock::time_point lastCommit;
+        bool writing = false;
+        bool flushRequested = false;
+        bool stopping = false;
+        bool failed = false;
+    };
+
+} // end namespace MyLibrary
+
+#endif // FILEIO_H
@@ -0,0 +1,209 @@
+#include "journal.h"
+#include "fileio.h"
+#include "taskmetrics.h"
+
+#include <cstring>
+#include <iostream>
+
+namespace MyLibrary
+{
+    /*--------------------- RECORD ENCODING ---------------------------------*/
+    // File:   "TODOJRNL" u32 version, then records
+    // Record: u32 payloadSize, u32 checksum(payload), payload
+    // Payload: u8 op, u64 seq, i32 id, u8 fields, then only the fields set:
+    //          u32 length + bytes (description), u8 priority, u8 completed,
+    //          i64 dueDate
+    namespace
+    {
+        const char kJournalMagic[8] = { 'T', 'O', 'D', 'O', 'J', 'R', 'N', 'L' };
+        const uint32_t kJournalVersion = 1;
+        const size_t kJournalHeaderSize = sizeof(kJournalMagic) + sizeof(uint32_t);
+        const size_t kRecordPrefixSize = 2 * sizeof(uint32_t);
+        const size_t kFlushThreshold = 64 * 1024;
+
+        uint32_t checksum(const char* data, size_t size) {
+            // FNV-1a; only needs to catch torn writes, not adversaries
+            uint32_t h = 2166136261u;
+            for (size_t i = 0; i < size; ++i) {
+                h ^= static_cast<uint8_t>(data[i]);
+                h *= 16777619u;
+            }
+            return h;
+        }
+
+        template <typename T>
+        void put(std::string& out, T value) {
+            out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+        }
+
+        template <typename T>
+        bool get(const char*& p, const char* end, T& value) {
+            if (static_cast<size_t>(end - p) < sizeof(value)) return false;
+            std::memcpy(&value, p, sizeof(value));
+            p += sizeof(value);
+            return true;
+        }
+
+        bool decode(const char* p, const char* end, JournalRecord& r) {
+            uint8_t op = 0;
+            if (!get(p, end, op) || !get(p, end, r.seq) || !get(p, end, r.id)
+                || !get(p, end, r.fields)) {
+                return false;
+            }
+            if (op < JOURNAL_ADD || op > JOURNAL_DELETE) return false;
+            r.op = static_cast<JournalOp>(op);
+
+            if (r.fields & FIELD_DESCRIPTION) {
+                uint32_t length = 0;
+                if (!get(p, end, length) || static_cast<size_t>(end - p) < length) return false;
+                r.description.assign(p, length);
+                p += length;
+            }
+            else {
+                r.description.clear();
+            }
+            if ((r.fields & FIELD_PRIORITY) && !get(p, end, r.priority)) return false;
+            if (r.fields & FIELD_COMPLETED) {
+                uint8_t completed = 0;
+                if (!get(p, end, completed)) return false;
+                r.completed = completed != 0;
+            }
+            if ((r.fields & FIELD_DUE_DATE) && !get(p, end, r.dueDate)) return false;
+            return p == end;
+        }
+    }
+
+    /*--------------------- JOURNAL ---------------------------------------*/
+
+    Journal::~Journal() {
+        close();
+    }
+
+    bool Journal::open(const std::string& path) {
+        close();
+        file = std::fopen(path.c_str(), "ab");
+        if (!file) {
+            std::cerr << "Error: Unable to open journal " << path << ".\n";
+            return false;
+        }
+        filePath = path;
+        std::fseek(file, 0, SEEK_END);
+        long existing = std::ftell(file);
+        fileBytes = existing > 0 ? static_cast<uint64_t>(existing) : 0;
+        if (fileBytes == 0) {
+            pending.append(kJournalMagic, sizeof(kJournalMagic));
+            put(pending, kJournalVersion);
+        }
+        return true;
+    }
+
+    void Journal::close() {
+        if (!file) return;
+        sync();
+        std::fclose(file);
+        file = nullptr;
+        filePath.clear();
+        fileBytes = 0;
+    }
+
+    void Journal::append(const JournalRecord& record) {
+        encode(record);
+        if (pending.size() >= kFlushThreshold) flush();
+    }
+
+    void Journal::appendAll(const std::vector<JournalRecord>& records) {
+        for (const JournalRecord& record : records) encode(record);
+        flush();
+    }
+
+    void Journal::encode(const JournalRecord& r) {
+        std::string payload;
+        put(payload, static_cast<uint8_t>(r.op));
+        put(payload, r.seq);
+        put(payload, r.id);
+        put(payload, r.fields);
+        if (r.fields & FIELD_DESCRIPTION) {
+            put(payload, static_cast<uint32_t>(r.description.size()));
+            payload += r.description;
+        }
+        if (r.fields & FIELD_PRIORITY) put(payload, r.priority);
+        if (r.fields & FIELD_COMPLETED) put(payload, static_cast<uint8_t>(r.completed ? 1 : 0));
+        if (r.fields & FIELD_DUE_DATE) put(payload, r.dueDate);
+
+        put(pending, static_cast<uint32_t>(payload.size()));
+        put(pending, checksum(payload.data(), payload.size()));
+        pending += payload;
+        TODO_COUNT(METRIC_JOURNAL_RECORDS, 1);
+    }
+
+    bool Journal::flush() {
+        if (!file) return false;
+        if (pending.empty()) return true;
+        size_t written = std::fwrite(pending.data(), 1, pending.size(), file);
+        fileBytes += written;
+        TODO_COUNT(METRIC_BYTES_WRITTEN, written);
+        bool ok = written == pending.size();
+        pending.clear();
+        if (!ok) {
+            std::cerr << "Error: Failed to write journal " << filePath << ".\n";
+        }
+        return ok;
+    }
+
+    bool Journal::sync() {
+        if (!flush()) return false;
+        if (!syncFile(file)) {
+            std::cerr << "Error: Failed to sync journal " << filePath << ".\n";
+            return false;
+        }
+        return true;
+    }
+
+    bool Journal::replay(const std::string& path,
+        const std::function<void(const JournalRecord&)>& apply,
+        uint64_t* validSize)
+    {
+        if (validSize) *validSize = 0;
+        MappedFile mapped;
+        if (!mapped.open(path) || mapped.size() == 0) return true;
+
+        const char* p = mapped.data();
+        const char* end = p + mapped.size();
+        if (mapped.size() < kJournalHeaderSize) {
+            // Crashed while creating the file; nothing was ever logged
+            std::cerr << "Warning: Ignoring torn header of " << path << ".\n";
+            return true;
+        }
+        uint32_t version = 0;
+        std::memcpy(&version, p + sizeof(kJournalMagic), sizeof(version));
+        if (version != kJournalVersion || std::memcmp(p, kJournalMagic, sizeof(kJournalMagic)) != 0) {
+            std::cerr << "Error: " << path << " is not a task journal.\n";
+            return false;
+        }
+        p += kJournalHeaderSize;
+
+        JournalRecord record;
+        while (p != end) {
+            uint32_t size = 0;
+            uint32_t sum = 0;
+            const char* payload = p + kRecordPrefixSize;
+            bool intact = static_cast<size_t>(end - p) >= kRecordPrefixSize;
+            if (intact) {
+                std::memcpy(&size, p, sizeof(size));
+                std::memcpy(&sum, p + sizeof(size), sizeof(sum));
+                intact = static_cast<size_t>(end - payload) >= size
+                    && checksum(payload, size) == sum
+                    && decode(payload, payload + size, record);
+            }
+            if (!intact) {
+                std::cerr << "Warning: Ignoring torn record at the end of " << path << ".\n";
+                break;
+            }
+            apply(record);
+            p = payload + size;
+        }
+        if (validSize) *validSize = static_cast<uint64_t>(p - mapped.data());
+        return true;
+    }
+
+} // end namespace MyLibrary
@@ -0,0 +1,94 @@
+#pragma once
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include <cstdio>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <functional>
+
+namespace MyLibrary
+{
+    enum JournalOp : uint8_t {
+        JOURNAL_ADD = 1,
+        JOURNAL_UPDATE,
+        JOURNAL_DELETE
+    };
+
+    // Which fields a JOURNAL_UPDATE record carries (JOURNAL_ADD carries all)
+    enum JournalField : uint8_t {
+        FIELD_DESCRIPTION = 1 << 0,
+        FIELD_PRIORITY = 1 << 1,
+        FIELD_COMPLETED = 1 << 2,
+        FIELD_DUE_DATE = 1 << 3,
+        FIELD_ALL = FIELD_DESCRIPTION | FIELD_PRIORITY | FIELD_COMPLETED | FIELD_DUE_DATE,
+        // JOURNAL_DELETE flag, no payload: the last task was moved into the gap
+        FIELD_SWAPPED = 1 << 4
+    };
+
+    /**
+     * One change to the task list. Every field is an absolute value, so
+     * replaying a record that is already reflected in the snapshot is harmless.
+     */
+    struct JournalRecord {
+        JournalOp op = JOURNAL_ADD;
+        uint64_t seq = 0;
+        int32_t id = 0;
+        uint8_t fields = 0;
+        std::string description;
+        uint8_t priority = 0;
+        bool completed = false;
+        int64_t dueDate = 0;
+    };
+
+    /**
+     * Append-only log of JournalRecords.
+     * Records are length-prefixed and checksummed; replay stops at the first
+     * torn or corrupt record, which can only be the tail of a crashed write.
+     */
+    class Journal {
+    public:
+        Journal() = default;
+        ~Journal();
+
+        Journal(const Journal&) = delete;
+        Journal& operator=(const Journal&) = delete;
+
+        // Open for appending, creating the file (with header) if needed.
+        bool open(const std::string& path);
+        void close();
+        bool isOpen() const { return file != nullptr; }
+        const std::string& path() const { return filePath; }
+
+        // Encode into the pending buffer; written out by flush/sync.
+        void append(const JournalRecord& record);
+        // Encode every record and write them out together in one flush.
+        void appendAll(const std::vector<JournalRecord>& records);
+        // Write pending records to the OS.
+        bool flush();
+        // Write pending records and fsync so they survive a crash.
+        bool sync();
+
+        // Bytes on disk plus bytes still pending
+        uint64_t size() const { return fileBytes + pending.size(); }
+
+        // Feed every intact record in the file to apply, in order.
+        // validSize receives the length of the intact prefix so a torn tail
+        // can be cut off before appending. A missing file is an empty journal.
+        static bool replay(const std::string& path,
+            const std::function<void(const JournalRecord&)>& apply,
+            uint64_t* validSize = nullptr);
+
+    private:
+        void encode(const JournalRecord& record);
+
+        std::FILE* file = nullptr;
+        std::string filePath;
+        std::string pending;
+        uint64_t fileBytes = 0;
+    };
+
+} // end namespace MyLibrary
+
+#endif // JOURNAL_H
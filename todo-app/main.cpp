@@ -1,15 +1,244 @@
 #include "mylibrary.h"
+#include "taskcommands.h"
+#include "taskserver.h"
 #include <iostream>
 #include <limits>
+#include <filesystem>
+#include <csignal>
 
-int main() {
+namespace
+{
+    MyLibrary::TaskServer* activeServer = nullptr;
+
+    extern "C" void stopServer(int) {
+        if (activeServer) activeServer->stop();
+    }
+
+    // JSON when the name ends in .json, Prometheus text otherwise
+    void writeMetricsFile(const std::string& path) {
+        if (path.empty()) return;
+        std::ofstream out(path);
+        if (!out) {
+            std::cerr << "Error: Unable to write metrics to " << path << ".\n";
+            return;
+        }
+        MyLibrary::MetricsSnapshot metrics = MyLibrary::Task::metrics();
+        if (std::filesystem::path(path).extension() == ".json") MyLibrary::writeJsonMetrics(out, metrics);
+        else MyLibrary::writePrometheusMetrics(out, metrics);
+    }
+}
+
+int main(int argc, char* argv[]) {
     using namespace MyLibrary;  // Pull in our library functions/classes
 
-    const std::string filename = "tasks.txt";
-    Task::loadTasksFromFile(filename);
+    // --journal: log every change to tasks.journal on top of tasks.snap
+    // --save-interval=MS: merge saves made within MS milliseconds; with
+    //   --serve and no journal, also how often changes are saved (default 1s)
+    // --threads=N: worker threads for bulk operations (0 = all cores)
+    // --intern: keep one copy of each distinct description
+    // --swap-delete: delete by moving the last task into the gap (reorders)
+    // --compress: write snapshots as compressed blocks (either kind loads)
+    // --remind: before each menu, print the tasks that have come due
+    // --limit=N: print at most N rows per listing
+    // --file=PATH: task list to open (default tasks.txt); the snapshot and
+    //   journal sit next to it as PATH with .snap / .journal extensions
+    // --batch[=FILE]: run line-protocol commands from FILE or stdin
+    //   (see TaskCommandRunner) instead of the menu
+    // --append: with --journal in batch mode, append changes to the journal
+    //   without loading the list
+    // --serve=[HOST:]PORT: keep the list loaded and serve the same commands
+    //   over TCP until interrupted (HOST defaults to 127.0.0.1)
+    // --metrics=FILE: on exit, write timers and counters to FILE (JSON for
+    //   .json, Prometheus text otherwise); they only move in builds with
+    //   TODO_ENABLE_METRICS
+    // Any other words form one command, e.g. todo-app add 2 2025-09-01 Call Bob
+    bool journalMode = false;
+    bool batchMode = false;
+    bool appendMode = false;
+    bool remindMode = false;
+    std::string batchFile;
+    std::string command;
+    std::string serveAddress;
+    std::string metricsFile;
+    std::chrono::milliseconds saveInterval{ 0 };
+    std::filesystem::path listFile = "tasks.txt";
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--journal") {
+            journalMode = true;
+        }
+        else if (arg.rfind("--save-interval=", 0) == 0) {
+            int ms = std::atoi(arg.c_str() + std::strlen("--save-interval="));
+            saveInterval = std::chrono::milliseconds(ms > 0 ? ms : 0);
+            Task::setSaveInterval(saveInterval);
+        }
+        else if (arg == "--intern") {
+            Task::setDescriptionInterning(true);
+        }
+        else if (arg == "--swap-delete") {
+            Task::setDeleteMode(DELETE_SWAP);
+        }
+        else if (arg == "--compress") {
+            Task::setSnapshotCompression(true);
+        }
+        else if (arg == "--remind") {
+            remindMode = true;
+        }
+        else if (arg.rfind("--limit=", 0) == 0) {
+            int rows = std::atoi(arg.c_str() + std::strlen("--limit="));
+            Task::setDisplayLimit(rows > 0 ? static_cast<size_t>(rows) : 0);
+        }
+        else if (arg.rfind("--threads=", 0) == 0) {
+            int threads = std::atoi(arg.c_str() + std::strlen("--threads="));
+            Task::setParallelism(threads > 0 ? static_cast<size_t>(threads) : 0);
+        }
+        else if (arg.rfind("--file=", 0) == 0) {
+            listFile = arg.substr(std::strlen("--file="));
+        }
+        else if (arg == "--batch") {
+            batchMode = true;
+        }
+        else if (arg.rfind("--batch=", 0) == 0) {
+            batchMode = true;
+            batchFile = arg.substr(std::strlen("--batch="));
+        }
+        else if (arg.rfind("--serve=", 0) == 0) {
+            serveAddress = arg.substr(std::strlen("--serve="));
+        }
+        else if (arg.rfind("--metrics=", 0) == 0) {
+            metricsFile = arg.substr(std::strlen("--metrics="));
+        }
+        else if (arg == "--append") {
+            appendMode = true;
+        }
+        else if (arg.rfind("--", 0) != 0) {
+            if (!command.empty()) command += ' ';
+            command += arg;
+        }
+        else {
+            std::cerr << "Unknown option: " << arg << "\n";
+            return 1;
+        }
+    }
+
+    const std::string filename = listFile.string();
+    const std::string snapshotFile = std::filesystem::path(listFile).replace_extension(".snap").string();
+    const std::string journalFile = std::filesystem::path(listFile).replace_extension(".journal").string();
+
+    // Start from whichever of the text file and binary snapshot was saved
+    // last; a journal left behind always builds on the snapshot.
+    if (!command.empty()) batchMode = true;
+    if (!serveAddress.empty() && batchMode) {
+        std::cerr << "Error: --serve cannot be combined with batch commands.\n";
+        return 1;
+    }
+    if (appendMode && !(journalMode && batchMode)) {
+        std::cerr << "Error: --append needs --journal and a batch or command.\n";
+        return 1;
+    }
+
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    // A clean exit folds the journal into the snapshot, so one that is still
+    // there holds changes nothing else has. Working without it would hand
+    // out its IDs again.
+    bool journalPending = fs::exists(journalFile, ec) || fs::exists(journalFile + ".old", ec);
+    if (journalPending && !journalMode) {
+        std::cerr << "Error: " << journalFile << " holds unsaved changes; run with --journal to load them.\n";
+        return 1;
+    }
+    bool useSnapshot = fs::exists(snapshotFile, ec)
+        && (journalPending || !fs::exists(filename, ec)
+            || fs::last_write_time(snapshotFile, ec) >= fs::last_write_time(filename, ec));
+    // Append-only needs the snapshot as the base; a newer text file would
+    // first have to be loaded anyway
+    bool appendOnly = appendMode && (useSnapshot || !fs::exists(filename, ec));
+    if (appendOnly) {
+        if (!Task::openJournalForAppend(journalFile, snapshotFile)) {
+            std::cerr << "Error: Unable to start journal mode.\n";
+            return 1;
+        }
+    }
+    else {
+        if (useSnapshot) {
+            Task::loadTasksFromSnapshot(snapshotFile);
+        }
+        else {
+            Task::loadTasksFromFile(filename);
+            // The journal is replayed onto the snapshot after a crash, so
+            // it has to hold what was just loaded
+            if (journalMode && fs::exists(snapshotFile, ec)) Task::saveTasksToSnapshot(snapshotFile);
+        }
+        if (journalMode && !Task::openJournal(journalFile, snapshotFile)) {
+            std::cerr << "Error: Unable to start journal mode.\n";
+            return 1;
+        }
+    }
+    TaskList::defaultList().setFile(filename);
+
+    if (batchMode) {
+        TaskCommandRunner runner(TaskList::defaultList(), std::cout);
+        if (!command.empty()) {
+            runner.execute(command);
+            runner.finish();
+        }
+        else if (batchFile.empty() || batchFile == "-") {
+            runner.run(std::cin);
+        }
+        else {
+            std::ifstream in(batchFile);
+            if (!in) {
+                std::cerr << "Error: Unable to open " << batchFile << ".\n";
+                return 1;
+            }
+            runner.run(in);
+        }
+        // Without the journal, changes only last once the file is written
+        if (!journalMode && runner.changes() > 0) Task::saveTasksToFile(filename);
+        Task::closeJournal();
+        Task::flushSaves();
+        writeMetricsFile(metricsFile);
+        return runner.failures() == 0 ? 0 : 1;
+    }
+    if (!serveAddress.empty()) {
+        size_t colon = serveAddress.rfind(':');
+        std::string host = colon == std::string::npos ? "127.0.0.1" : serveAddress.substr(0, colon);
+        int port = std::atoi(serveAddress.c_str() + (colon == std::string::npos ? 0 : colon + 1));
+        // Printed before the server takes over the list's output
+        Task::displayLoadStats();
+        TaskServer server(TaskList::defaultList());
+        if (port <= 0 || port > 65535 || !server.listen(host, static_cast<uint16_t>(port))) {
+            std::cerr << "Error: Unable to serve on " << serveAddress << ".\n";
+            return 1;
+        }
+        std::cout << "Serving " << filename << " on " << host << ":" << server.port() << std::endl;
+        if (!journalMode) server.saveEvery(filename, saveInterval.count() > 0 ? saveInterval : std::chrono::seconds(1));
+
+        activeServer = &server;
+        std::signal(SIGINT, stopServer);
+        std::signal(SIGTERM, stopServer);
+        bool served = server.run();
+        activeServer = nullptr;
+
+        // The background saves have to land before the final one
+        Task::waitForSaves();
+        if (!journalMode && server.changes() > 0) Task::saveTasksToFile(filename);
+        Task::closeJournal();
+        Task::flushSaves();
+        writeMetricsFile(metricsFile);
+        return served ? 0 : 1;
+    }
+    Task::displayLoadStats();
 
+    DateFormatter reminderDates;
     bool running = true;
     while (running) {
+        if (remindMode) {
+            Task::fireReminders(std::time(nullptr), [&](const Task& task) {
+                std::cout << "Reminder: task " << task.getId() << " \"" << task.getDescription()
+                    << "\" was due " << reminderDates.format(task.getDueDate()) << ".\n";
+            });
+        }
         std::cout << "\n========== TO-DO LIST MANAGER ==========\n"
             << "1. Add Task\n"
             << "2. Edit Task\n"
@@ -17,10 +246,14 @@ int main() {
             << "4. Mark Task as Completed\n"
             << "5. Display All Tasks\n"
             << "6. Filter by Status (Completed/Pending)\n"
-            << "7. Sort Tasks by Priority\n"
-            << "8. Sort Tasks by Due Date\n"
+            << "7. Display Tasks by Priority\n"
+            << "8. Display Tasks by Due Date\n"
             << "9. Display Completion Percentage\n"
             << "10. Save Tasks\n"
+            << "11. Save Binary Snapshot\n"
+            << "12. Display Statistics\n"
+            << "13. Display Tasks Due This Week\n"
+            << "14. Search Tasks\n"
             << "0. Exit\n"
             << "========================================\n"
             << "Enter your choice: ";
@@ -171,7 +404,7 @@ int main() {
             }
             break;
         }
-        case 7: { // Sort by Priority
+        case 7: { // Display by Priority
             std::cout << "Sort by priority:\n"
                 << "1. Ascending\n"
                 << "2. Descending\n"
@@ -185,17 +418,17 @@ int main() {
                 break;
             }
             if (sortChoice == 1) {
-                Task::sortTasksByPriority(true);
+                Task::displayTasksByPriority(true);
             }
             else if (sortChoice == 2) {
-                Task::sortTasksByPriority(false);
+                Task::displayTasksByPriority(false);
             }
             else {
                 std::cerr << "Invalid choice.\n";
             }
             break;
         }
-        case 8: { // Sort by Due Date
+        case 8: { // Display by Due Date
             std::cout << "Sort by due date:\n"
                 << "1. Ascending\n"
                 << "2. Descending\n"
@@ -209,10 +442,10 @@ int main() {
                 break;
             }
             if (sortChoice == 1) {
-                Task::sortTasksByDueDate(true);
+                Task::displayTasksByDueDate(true);
             }
             else if (sortChoice == 2) {
-                Task::sortTasksByDueDate(false);
+                Task::displayTasksByDueDate(false);
             }
             else {
                 std::cerr << "Invalid choice.\n";
@@ -223,9 +456,47 @@ int main() {
             Task::displayCompletionPercentage();
             break;
         case 10:
-            Task::saveTasksToFile(filename);
-            std::cout << "Tasks saved to file.\n";
+            if (Task::isJournaling()) {
+                // Only the changes since the last save need to hit the disk
+                Task::syncJournal();
+                std::cout << "Changes written to journal.\n";
+                break;
+            }
+            // Written from a copy, so the menu stays usable on big lists;
+            // a failed save reports itself
+            Task::saveTasksToFileAsync(filename);
+            std::cout << "Saving tasks in the background.\n";
             break;
+        case 11:
+            Task::saveTasksToSnapshot(snapshotFile);
+            std::cout << "Tasks saved to snapshot.\n";
+            break;
+        case 12:
+            Task::displayStats();
+            break;
+        case 13: { // Due in the next 7 days, starting today
+            time_t now = std::time(nullptr);
+            tm day{};
+            toLocalTime(now, day);
+            day.tm_hour = 0;
+            day.tm_min = 0;
+            day.tm_sec = 0;
+            day.tm_isdst = -1;
+            time_t from = std::mktime(&day);
+            day.tm_mday += 7;
+            day.tm_isdst = -1;
+            time_t before = std::mktime(&day);
+            Task::displayTasksDueBetween(from, before);
+            break;
+        }
+        case 14: { // Search descriptions
+            std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+            std::cout << "Enter words to search for (word* matches a prefix): ";
+            std::string query;
+            std::getline(std::cin, query);
+            Task::displaySearchResults(query);
+            break;
+        }
         case 0:
             running = false;
             break;
@@ -237,6 +508,10 @@ int main() {
 
     // Optionally, auto-save before exiting.
     // Task::saveTasksToFile(filename);
+    Task::waitForSaves();
+    Task::closeJournal();
+    Task::flushSaves();
+    writeMetricsFile(metricsFile);
 
     std::cout << "Exiting program. Goodbye.\n";
     return 0;
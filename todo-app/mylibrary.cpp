@@ -1,14 +1,106 @@
 #include "mylibrary.h"
 
+#include <charconv>
+
 #ifdef _MSC_VER
 #define _CRT_SECURE_NO_WARNINGS  // If you want to suppress MSVC localtime deprecation warnings
 #endif
 
 namespace MyLibrary
 {
+    /*--------------------- FILE FORMAT ---------------------------------*/
+    // First line of a versioned tasks file, followed by " next=<nextId>".
+    // Rows are: id|description|priority completed dueDate
+    // Files without this header use the original description|priority
+    // completed dueDate rows and get fresh IDs on load.
+    static const char* const kFormatHeader = "#todo-tasks v2";
+    static const char* const kHeaderPrefix = "#todo-tasks v";
+
     /*--------------------- STATIC MEMBER DEFINITIONS ---------------------*/
-    int Task::nextId = 1;
-    std::vector<Task> Task::tasks;
+    GroupCommitWriter TaskList::saveWriter;
+
+    /*--------------------- PARSING HELPERS -------------------------------*/
+
+    // Split off the next line (without its '\n' or '\r'), advancing rest.
+    static std::string_view nextLine(std::string_view& rest) {
+        size_t end = rest.find('\n');
+        std::string_view line = rest.substr(0, end);
+        rest.remove_prefix(end == std::string_view::npos ? rest.size() : end + 1);
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+        return line;
+    }
+
+    // Parse an integer after optional spaces, advancing text past it.
+    template <typename T>
+    static bool parseNumber(std::string_view& text, T& out) {
+        size_t i = 0;
+        while (i < text.size() && (text[i] == ' ' || text[i] == '\t')) ++i;
+        const char* first = text.data() + i;
+        const char* last = text.data() + text.size();
+        auto result = std::from_chars(first, last, out);
+        if (result.ec != std::errc()) return false;
+        text.remove_prefix(static_cast<size_t>(result.ptr - text.data()));
+        return true;
+    }
+
+    namespace
+    {
+        // Rows parsed from one newline-aligned chunk of a tasks file
+        struct ParsedChunk {
+            std::string_view text;
+            TaskRows rows;
+            // For each malformed row, the number of good rows before it
+            std::vector<size_t> rejectedAt;
+            int maxId = 0;
+        };
+
+        // Parse without printing, so chunks can run on any thread; the
+        // loader reports the rejected rows afterwards in file order.
+        void parseChunk(bool versioned, ParsedChunk& chunk) {
+            std::string_view rest = chunk.text;
+            chunk.rows.reserve(static_cast<size_t>(std::count(rest.begin(), rest.end(), '\n')) + 1);
+            while (!rest.empty()) {
+                std::string_view row = nextLine(rest);
+                if (row.empty()) continue;
+
+                int id = 0;
+                if (versioned) {
+                    if (!parseNumber(row, id) || row.empty() || row.front() != '|') {
+                        chunk.rejectedAt.push_back(chunk.rows.size());
+                        continue;
+                    }
+                    row.remove_prefix(1);
+                }
+
+                // The numbers follow the last '|', so a '|' inside the
+                // description does not cut it short
+                size_t bar = row.rfind('|');
+                if (bar == std::string_view::npos) {
+                    chunk.rejectedAt.push_back(chunk.rows.size());
+                    continue;
+                }
+                std::string_view desc = row.substr(0, bar);
+                row.remove_prefix(bar + 1);
+
+                int prioInt = 0;
+                int compInt = 0;
+                time_t due = 0;
+                bool parsed = parseNumber(row, prioInt)
+                    && parseNumber(row, compInt)
+                    && parseNumber(row, due);
+
+                if (!parsed || desc.empty() || prioInt < HIGHEST || prioInt > LOWEST
+                    || (versioned && id <= 0)) {
+                    chunk.rejectedAt.push_back(chunk.rows.size());
+                    continue;
+                }
+                // desc points into the mapped file, which outlives the batch.
+                // Unversioned rows get their IDs once all chunks are done.
+                chunk.rows.push(id, desc, static_cast<uint8_t>(prioInt), compInt != 0, due);
+                if (id > chunk.maxId) chunk.maxId = id;
+            }
+        }
+    }
 
     /*--------------------- FREE FUNCTION IMPLEMENTATIONS -----------------*/
 
@@ -84,15 +176,67 @@ namespace MyLibrary
 
     /*-------------------- TASK CLASS IMPLEMENTATIONS ---------------------*/
 
-    Task::Task(const std::string& desc, Priority prio, time_t due)
-        : id(nextId++), description(desc), priority(prio), completed(false), dueDate(due)
+    Task::Task(const TaskStore& store, size_t slot)
+        : store(&store), slot(slot)
+    {}
+
+    TaskList::TaskList(std::string file)
+        : fileName(std::move(file))
     {}
 
-    bool Task::validateTask(const std::string& desc, Priority prio) {
+    TaskList::~TaskList() {
+        waitForSaves();
+        closeJournal();
+    }
+
+    TaskList& TaskList::defaultList() {
+        static TaskList list;
+        return list;
+    }
+
+    bool TaskList::load() {
+        if (fileName.empty()) return false;
+        loadTasksFromFile(fileName);
+        return true;
+    }
+
+    bool TaskList::save() {
+        if (fileName.empty()) return false;
+        saveTasksToFile(fileName);
+        return true;
+    }
+
+    void TaskList::setOutput(std::ostream& out) {
+        display = &out;
+        listing.reset();  // the table writes to the old stream
+    }
+
+    TaskTable& TaskList::output() {
+        if (!listing) {
+            listing = std::make_unique<TaskTable>(*display);
+            listing->setLimit(displayLimit);
+        }
+        return *listing;
+    }
+
+    bool TaskList::isValidDescription(std::string_view desc) {
+        // A task file row is one line with '|' before the numbers
+        return !desc.empty() && desc.find_first_of("|\r\n") == std::string_view::npos;
+    }
+
+    bool TaskList::isValidTask(std::string_view desc, Priority prio) {
+        return isValidDescription(desc) && prio >= HIGHEST && prio <= LOWEST;
+    }
+
+    bool TaskList::validateTask(std::string_view desc, Priority prio) {
         if (desc.empty()) {
             std::cerr << "Error: Description cannot be empty.\n";
             return false;
         }
+        if (!isValidDescription(desc)) {
+            std::cerr << "Error: Description cannot contain '|' or line breaks.\n";
+            return false;
+        }
         if (prio < HIGHEST || prio > LOWEST) {
             std::cerr << "Error: Priority must be between 1 and 5.\n";
             return false;
@@ -100,223 +244,1044 @@ namespace MyLibrary
         return true;
     }
 
-    void Task::loadTasksFromFile(const std::string& filename) {
-        std::ifstream file(filename);
-        if (!file.is_open()) {
+    size_t TaskList::count() const {
+        return tasks.size();
+    }
+
+    Task TaskList::at(size_t position) {
+        return Task(tasks, position);
+    }
+
+    std::optional<Task> TaskList::find(int id) {
+        size_t slot = tasks.find(id);
+        if (slot == TaskIndex::npos) return {};
+        return Task(tasks, slot);
+    }
+
+    size_t TaskList::insertTask(int id, std::string_view desc, Priority prio, bool comp, time_t due) {
+        return tasks.push(id, desc, static_cast<uint8_t>(prio), comp, due);
+    }
+
+    void TaskList::loadTasksFromFile(const std::string& filename) {
+        TODO_TIME_SCOPE(METRIC_LOAD);
+        auto start = std::chrono::steady_clock::now();
+
+        MappedFile file;
+        if (!file.open(filename)) {
             // If file not found, not necessarily an error; do nothing
             return;
         }
+        std::string_view rest = file.view();
+        if (isSnapshotData(rest)) {
+            // Binary snapshots are accepted here as well
+            if (loadSnapshotData(rest)) finishLoadStats(start, file.size());
+            return;
+        }
+
+        // Versioned files start with a header line; anything else is the
+        // original unversioned format without IDs.
+        bool versioned = false;
+        int headerNextId = 0;
+        // Only "#todo-tasks v..." is a header; a legacy task may start with '#'
+        if (rest.compare(0, std::strlen(kHeaderPrefix), kHeaderPrefix) == 0) {
+            std::string_view header = nextLine(rest);
+            if (header.compare(0, std::strlen(kFormatHeader), kFormatHeader) != 0) {
+                std::cerr << "Error: Unsupported task file format.\n";
+                return;
+            }
+            versioned = true;
+            size_t pos = header.find("next=");
+            if (pos != std::string_view::npos) {
+                header.remove_prefix(pos + 5);
+                parseNumber(header, headerNextId);
+            }
+        }
+
+        // Cut the rows into newline-aligned chunks and parse them in parallel
+        size_t chunkCount = splitWork(rest.size(), 1 << 20);
+        std::vector<ParsedChunk> chunks(chunkCount);
+        size_t begin = 0;
+        for (size_t c = 0; c < chunkCount; ++c) {
+            size_t end = rest.size();
+            if (c + 1 < chunkCount) {
+                end = rest.find('\n', std::max(begin, chunkBegin(rest.size(), chunkCount, c + 1)));
+                end = end == std::string_view::npos ? rest.size() : end + 1;
+            }
+            chunks[c].text = rest.substr(begin, end - begin);
+            begin = end;
+        }
+        parallelFor(chunkCount, [&](size_t c) { parseChunk(versioned, chunks[c]); });
 
         tasks.clear();
-        while (true) {
-            if (!file.good() || file.peek() == EOF) break;
+        journalSeq = 0;
+        size_t total = 0;
+        for (const ParsedChunk& chunk : chunks) total += chunk.rows.size();
+        tasks.reserve(total);
+
+        // Merge in file order, which also fixes the IDs given to legacy rows
+        int maxID = 0;
+        std::vector<size_t> duplicates;
+        for (ParsedChunk& chunk : chunks) {
+            if (!versioned) {
+                for (int& id : chunk.rows.ids) id = nextId++;
+                if (chunk.rows.size() > 0) maxID = nextId - 1;
+            }
+            else if (chunk.maxId > maxID) {
+                maxID = chunk.maxId;
+            }
+            duplicates.clear();
+            tasks.append(chunk.rows, &duplicates);
+
+            size_t r = 0;
+            size_t d = 0;
+            while (r < chunk.rejectedAt.size() || d < duplicates.size()) {
+                if (d == duplicates.size() || (r < chunk.rejectedAt.size() && chunk.rejectedAt[r] <= duplicates[d])) {
+                    std::cerr << "Skipping invalid task from file.\n";
+                    ++r;
+                }
+                else {
+                    std::cerr << "Skipping duplicate task ID " << chunk.rows.ids[duplicates[d]] << " from file.\n";
+                    ++d;
+                }
+            }
+            chunk.rows = TaskRows();  // release the chunk's buffers as we go
+        }
 
-            std::string desc;
-            getline(file, desc, '|');  // read description until '|'
-            if (!file.good()) break;
+        // Sync nextId if tasks loaded; the header keeps IDs of deleted
+        // tasks from being handed out again.
+        nextId = std::max(maxID + 1, headerNextId);
 
-            int prioInt = 0;
-            int compInt = 0;
-            time_t due = 0;
+        finishLoadStats(start, file.size());
+    }
 
-            file >> prioInt;
-            if (!file.good()) break;
+    void TaskList::finishLoadStats(std::chrono::steady_clock::time_point start, size_t bytes) {
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        loadStats.tasksLoaded = tasks.size();
+        loadStats.bytesRead = bytes;
+        loadStats.seconds = elapsed.count();
+    }
 
-            file >> compInt;
-            if (!file.good()) break;
+    const LoadStats& TaskList::lastLoadStats() const {
+        return loadStats;
+    }
 
-            file >> due;
-            if (!file.good()) break;
+    void TaskList::displayLoadStats() {
+        double mb = loadStats.bytesRead / (1024.0 * 1024.0);
+        double rate = loadStats.seconds > 0 ? mb / loadStats.seconds : 0.0;
+        *display << "Loaded " << loadStats.tasksLoaded << " tasks ("
+            << std::fixed << std::setprecision(2) << mb << " MB) in "
+            << loadStats.seconds * 1000.0 << " ms, "
+            << rate << " MB/s\n";
+    }
 
-            file.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    template <typename Rows>
+    void TaskList::appendTaskRow(std::string& out, const Rows& source, size_t slot) {
+        // Format: id|description|priority completed dueDate
+        char number[24];
+        auto appendNumber = [&](auto value) {
+            auto result = std::to_chars(number, number + sizeof(number), value);
+            out.append(number, static_cast<size_t>(result.ptr - number));
+        };
+        appendNumber(source.id(slot));
+        out += '|';
+        out += source.description(slot);
+        out += '|';
+        appendNumber(static_cast<int>(source.priority(slot)));
+        out += ' ';
+        out += source.completed(slot) ? '1' : '0';
+        out += ' ';
+        appendNumber(source.dueDate(slot));
+        out += '\n';
+    }
 
-            if (desc.empty() || prioInt < HIGHEST || prioInt > LOWEST) {
-                std::cerr << "Skipping invalid task from file.\n";
-                continue;
-            }
+    template <typename Rows>
+    void TaskList::formatTasks(const Rows& source, int next, size_t batch,
+        const std::function<void(std::vector<std::string>&)>& sink)
+    {
+        std::vector<std::string> parts(1);
+        parts[0] += kFormatHeader;
+        parts[0] += " next=" + std::to_string(next) + "\n";
+        sink(parts);
 
-            Task task(desc, static_cast<Priority>(prioInt), due);
-            task.completed = static_cast<bool>(compInt);
-            tasks.push_back(task);
-        }
-        file.close();
+        // Rows are formatted in parallel chunks and handed on in order, a
+        // batch at a time, so only a few MB of text need be held at once.
+        const size_t rowsPerChunk = 16384;
+        size_t n = source.size();
+        size_t chunkCount = (n + rowsPerChunk - 1) / rowsPerChunk;
+        if (batch == 0) batch = std::max<size_t>(chunkCount, 1);
+        std::vector<std::vector<size_t>> rejected;
+        for (size_t first = 0; first < chunkCount; first += batch) {
+            size_t count = std::min(batch, chunkCount - first);
+            parts.assign(count, std::string());
+            rejected.assign(count, std::vector<size_t>());
+            parallelFor(count, [&](size_t chunk) {
+                size_t begin = (first + chunk) * rowsPerChunk;
+                size_t end = std::min(n, begin + rowsPerChunk);
+                std::string& out = parts[chunk];
+                out.reserve((end - begin) * 48);
+                for (size_t slot = begin; slot < end; ++slot) {
+                    // Same rules as validateTask; the messages are printed below,
+                    // in slot order, rather than from the worker threads
+                    if (!isValidTask(source.description(slot), static_cast<Priority>(source.priority(slot)))) {
+                        rejected[chunk].push_back(slot);
+                        continue;
+                    }
+                    appendTaskRow(out, source, slot);
+                }
+            });
 
-        // Sync nextId if tasks loaded
-        int maxID = 0;
-        for (auto& task : tasks) {
-            if (task.id > maxID) maxID = task.id;
+            for (size_t chunk = 0; chunk < count; ++chunk) {
+                for (size_t slot : rejected[chunk]) {
+                    validateTask(source.description(slot), static_cast<Priority>(source.priority(slot)));
+                    std::cerr << "Error: Invalid Task with ID " << source.id(slot) << " - not saved.\n";
+                }
+            }
+            sink(parts);
         }
-        nextId = maxID + 1;
     }
 
-    void Task::saveTasksToFile(const std::string& filename) {
-        std::ofstream file(filename);
-        if (!file.is_open()) {
+    template <typename Rows>
+    bool TaskList::writeTasksFile(const Rows& source, int next, const std::string& filename, bool wait) {
+        TODO_TIME_SCOPE(METRIC_SAVE);
+        // With a group-commit interval the text is handed to the background
+        // writer; otherwise it is streamed into the temp file.
+        if (saveWriter.interval().count() > 0) {
+            std::string text;
+            text.reserve(source.size() * 48);
+            formatTasks(source, next, 0, [&](std::vector<std::string>& parts) {
+                for (const std::string& part : parts) text += part;
+            });
+            std::shared_future<bool> committed = saveWriter.submit(filename, std::move(text));
+            return wait ? committed.get() : true;
+        }
+
+        AtomicFileWriter file;
+        if (!file.open(filename)) {
             std::cerr << "Error: Unable to open file for saving.\n";
-            return;
+            return false;
         }
-        for (auto& task : tasks) {
-            if (!validateTask(task.description, task.priority)) {
-                std::cerr << "Error: Invalid Task with ID " << task.id << " - not saved.\n";
-                continue;
-            }
-            // Format: description|priority completed dueDate
-            file << task.description << "|"
-                << task.priority << " "
-                << task.completed << " "
-                << task.dueDate << "\n";
+        // Two stages: while one batch is written out, the pool formats the next
+        std::future<void> writing;
+        formatTasks(source, next, parallelism() * 2, [&](std::vector<std::string>& parts) {
+            if (writing.valid()) writing.get();
+            writing = std::async(std::launch::async, [&file, batch = std::move(parts)]() {
+                for (const std::string& part : batch) file.write(part);
+            });
+        });
+        if (writing.valid()) writing.get();
+        if (!file.commit()) {
+            std::cerr << "Error: Failed to save tasks to " << filename << ".\n";
+            return false;
+        }
+        return true;
+    }
+
+    void TaskList::saveTasksToFile(const std::string& filename) {
+        waitForSaves();  // an older background save must not land after this one
+        writeTasksFile(tasks, nextId, filename, false);
+    }
+
+    std::shared_future<bool> TaskList::saveTasksToFileAsync(const std::string& filename,
+        std::function<void(bool)> done)
+    {
+        // Taking the snapshot is O(1). Edits carry on against the live
+        // store; the first one while this save runs copies the columns.
+        std::shared_future<bool> previous = lastSave;
+        lastSave = std::async(std::launch::async,
+            [previous, filename, done = std::move(done), copy = tasks.columns(), next = nextId]() {
+                // Saves commit in the order they were started
+                if (previous.valid()) previous.wait();
+                bool saved = writeTasksFile(copy, next, filename, true);
+                if (done) done(saved);
+                return saved;
+            }).share();
+        return lastSave;
+    }
+
+    bool TaskList::waitForSaves() {
+        if (!lastSave.valid()) return true;
+        bool saved = lastSave.get();
+        lastSave = std::shared_future<bool>();
+        return saved;
+    }
+
+    void TaskList::setParallelism(size_t threads) {
+        MyLibrary::setParallelism(threads);
+    }
+
+    void TaskList::setDisplayLimit(size_t rows) {
+        displayLimit = rows;
+        if (listing) listing->setLimit(rows);
+    }
+
+    void TaskList::displayTasks(size_t offset) {
+        output().setOffset(offset);
+        displayTasks();
+        output().setOffset(0);  // still set if there was nothing to list
+    }
+
+    void TaskList::setDescriptionInterning(bool on) {
+        tasks.setInterning(on);
+    }
+
+    void TaskList::setSaveInterval(std::chrono::milliseconds interval) {
+        saveWriter.setInterval(interval);
+    }
+
+    bool TaskList::flushSaves() {
+        return saveWriter.flush();
+    }
+
+    void TaskList::addTask(std::string_view desc, Priority prio, time_t due) {
+        emplaceTask(desc, prio, due);
+    }
+
+    int TaskList::emplaceTask(std::string_view desc, Priority prio, time_t due, bool completed) {
+        TODO_TIME_SCOPE(METRIC_ADD);
+        if (!validateTask(desc, prio)) return 0;
+        int id = nextId++;
+        if (!appendOnly) insertTask(id, desc, prio, completed, due);
+
+        if (isJournaling()) {
+            JournalRecord record;
+            record.op = JOURNAL_ADD;
+            record.id = id;
+            record.fields = FIELD_ALL;
+            record.description = desc;
+            record.priority = static_cast<uint8_t>(prio);
+            record.completed = completed;
+            record.dueDate = due;
+            logChange(record);
         }
-        file.close();
+        return id;
+    }
+
+    void TaskList::reserveTasks(size_t count, size_t textBytes) {
+        tasks.reserve(count, textBytes);
     }
 
-    void Task::addTask(const std::string& desc, Priority prio, time_t due) {
-        if (validateTask(desc, prio)) {
-            tasks.push_back(Task(desc, prio, due));
+    void TaskList::setDeleteMode(DeleteMode mode) {
+        deleteMode = mode;
+    }
+
+    ConcurrentTaskStore& TaskList::beginConcurrentMode(size_t shards) {
+        if (!concurrent) {
+            concurrent = std::make_unique<ConcurrentTaskStore>(tasks, nextId, shards);
+            tasks.clear();
         }
+        return *concurrent;
     }
 
-    void Task::deleteTask(int id) {
-        size_t oldSize = tasks.size();
-        tasks.erase(std::remove_if(tasks.begin(), tasks.end(),
-            [id](const Task& t) { return t.id == id; }),
-            tasks.end());
-        if (tasks.size() == oldSize) {
+    void TaskList::endConcurrentMode() {
+        if (!concurrent) return;
+        concurrent->exportTo(tasks);
+        nextId = concurrent->peekNextId();
+        concurrent.reset();
+        if (isJournaling()) compactJournal();
+    }
+
+    bool TaskList::isConcurrent() const {
+        return concurrent != nullptr;
+    }
+
+    void TaskList::deleteTask(int id) {
+        TODO_TIME_SCOPE(METRIC_DELETE);
+        if (appendOnly) {
+            Mutation change;
+            change.op = MUTATION_DELETE;
+            change.id = id;
+            appendBatch({ change });
+            return;
+        }
+        size_t slot = tasks.find(id);
+        if (slot == TaskIndex::npos) {
             std::cerr << "Warning: No task found with ID " << id << ".\n";
+            return;
+        }
+        if (deleteMode == DELETE_SWAP) tasks.eraseSwapLast(slot);
+        else tasks.erase(slot);
+
+        if (isJournaling()) {
+            JournalRecord record;
+            record.op = JOURNAL_DELETE;
+            record.id = id;
+            // Replay has to close the gap the same way
+            if (deleteMode == DELETE_SWAP) record.fields = FIELD_SWAPPED;
+            logChange(record);
         }
     }
 
-    void Task::updateTask(int id,
-        std::optional<std::string> desc,
-        std::optional<Priority> prio,
-        std::optional<bool> comp,
-        std::optional<time_t> due)
-    {
-        for (auto& task : tasks) {
-            if (task.id == id) {
-                if (desc) {
-                    if (!validateTask(*desc, task.priority)) {
-                        std::cerr << "Update failed due to invalid description.\n";
-                        return;
-                    }
-                    task.description = *desc;
+    std::vector<MutationResult> TaskList::applyBatch(const std::vector<Mutation>& batch) {
+        TODO_TIME_SCOPE(METRIC_BATCH);
+        if (appendOnly) return appendBatch(batch);
+        std::vector<MutationResult> results(batch.size());
+        std::vector<JournalRecord> records;
+        std::vector<size_t> doomed;
+        std::vector<int> doomedIds;
+        // Slots deleted so far; they stay in place until the end
+        std::vector<uint64_t> deleted((tasks.size() + 63) / 64, 0);
+        auto isDeleted = [&](size_t slot) {
+            return slot < deleted.size() * 64 && ((deleted[slot >> 6] >> (slot & 63)) & 1);
+        };
+        bool journaling = isJournaling();
+
+        for (size_t i = 0; i < batch.size(); ++i) {
+            const Mutation& m = batch[i];
+            MutationResult& result = results[i];
+            result.id = m.id;
+
+            if (m.op == MUTATION_ADD) {
+                result.id = 0;
+                time_t due = m.dueDate.value_or(0);
+                bool comp = m.completed.value_or(false);
+                if (!m.description || !m.priority || !isValidTask(*m.description, *m.priority)) {
+                    result.status = MUTATION_INVALID;
+                    continue;
                 }
-                if (prio) {
-                    if (!validateTask(task.description, *prio)) {
-                        std::cerr << "Update failed due to invalid priority.\n";
-                        return;
-                    }
-                    task.priority = *prio;
+                result.id = nextId++;
+                insertTask(result.id, *m.description, *m.priority, comp, due);
+                if (journaling) {
+                    JournalRecord record;
+                    record.op = JOURNAL_ADD;
+                    record.id = result.id;
+                    record.fields = FIELD_ALL;
+                    record.description = *m.description;
+                    record.priority = static_cast<uint8_t>(*m.priority);
+                    record.completed = comp;
+                    record.dueDate = due;
+                    records.push_back(std::move(record));
                 }
-                if (comp) {
-                    task.completed = *comp;
+                continue;
+            }
+
+            size_t slot = tasks.find(m.id);
+            if (slot == TaskIndex::npos || isDeleted(slot)) {
+                result.status = MUTATION_NOT_FOUND;
+                continue;
+            }
+
+            if (m.op == MUTATION_DELETE) {
+                // The slot may belong to a task added earlier in this batch
+                if ((slot >> 6) >= deleted.size()) deleted.resize((slot >> 6) + 1, 0);
+                deleted[slot >> 6] |= uint64_t(1) << (slot & 63);
+                doomed.push_back(slot);
+                doomedIds.push_back(m.id);
+                continue;
+            }
+
+            Mutation change;
+            if (m.op == MUTATION_COMPLETE) change.completed = true;
+            else change = m;
+            const std::optional<std::string_view>& desc = change.description;
+            const std::optional<Priority>& prio = change.priority;
+            const std::optional<bool>& comp = change.completed;
+            const std::optional<time_t>& due = change.dueDate;
+            Priority current = static_cast<Priority>(tasks.priority(slot));
+            if ((desc && !isValidTask(*desc, current))
+                || (prio && !isValidTask(desc ? *desc : tasks.description(slot), *prio))) {
+                result.status = MUTATION_INVALID;
+                continue;
+            }
+
+            JournalRecord record;
+            record.op = JOURNAL_UPDATE;
+            record.id = m.id;
+            if (desc) {
+                record.fields |= FIELD_DESCRIPTION;
+                if (journaling) record.description = *desc;
+                tasks.setDescription(slot, *desc);
+            }
+            if (prio) {
+                tasks.setPriority(slot, static_cast<uint8_t>(*prio));
+                record.fields |= FIELD_PRIORITY;
+                record.priority = static_cast<uint8_t>(*prio);
+            }
+            if (comp) {
+                tasks.setCompleted(slot, *comp);
+                record.fields |= FIELD_COMPLETED;
+                record.completed = *comp;
+            }
+            if (due) {
+                tasks.setDueDate(slot, *due);
+                record.fields |= FIELD_DUE_DATE;
+                record.dueDate = *due;
+            }
+            if (journaling) records.push_back(std::move(record));
+        }
+
+        if (!doomed.empty()) {
+            if (deleteMode == DELETE_SWAP) {
+                // Highest slot first, so the task moved into each gap is
+                // never one that is still waiting to be deleted
+                std::vector<size_t> order(doomed.size());
+                for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+                std::sort(order.begin(), order.end(),
+                    [&](size_t a, size_t b) { return doomed[a] > doomed[b]; });
+                for (size_t i : order) {
+                    tasks.eraseSwapLast(doomed[i]);
+                    if (!journaling) continue;
+                    // Logged in the order they ran, so replay moves the same rows
+                    JournalRecord record;
+                    record.op = JOURNAL_DELETE;
+                    record.id = doomedIds[i];
+                    record.fields = FIELD_SWAPPED;
+                    records.push_back(std::move(record));
                 }
-                if (due) {
-                    task.dueDate = *due;
+            }
+            else {
+                std::sort(doomed.begin(), doomed.end());
+                tasks.eraseSlots(doomed);
+                for (size_t i = 0; journaling && i < doomedIds.size(); ++i) {
+                    JournalRecord record;
+                    record.op = JOURNAL_DELETE;
+                    record.id = doomedIds[i];
+                    records.push_back(std::move(record));
                 }
-                return;
             }
         }
-        std::cerr << "Warning: No task found with ID " << id << ".\n";
+
+        if (journaling) logChanges(records);
+        return results;
     }
 
-    void Task::displayTasks() {
+    void TaskList::updateTask(int id,
+        std::optional<std::string_view> desc,
+        std::optional<Priority> prio,
+        std::optional<bool> comp,
+        std::optional<time_t> due)
+    {
+        TODO_TIME_SCOPE(METRIC_UPDATE);
+        if (appendOnly) {
+            Mutation change;
+            change.id = id;
+            change.description = desc;
+            change.priority = prio;
+            change.completed = comp;
+            change.dueDate = due;
+            if (appendBatch({ change })[0].status == MUTATION_INVALID) {
+                std::cerr << "Update failed due to invalid description or priority.\n";
+            }
+            return;
+        }
+        size_t slot = tasks.find(id);
+        if (slot == TaskIndex::npos) {
+            std::cerr << "Warning: No task found with ID " << id << ".\n";
+            return;
+        }
+        // Validate everything first so a rejected update changes nothing
+        Priority current = static_cast<Priority>(tasks.priority(slot));
+        if (desc && !validateTask(*desc, current)) {
+            std::cerr << "Update failed due to invalid description.\n";
+            return;
+        }
+        if (prio && !validateTask(desc ? *desc : tasks.description(slot), *prio)) {
+            std::cerr << "Update failed due to invalid priority.\n";
+            return;
+        }
+
+        JournalRecord record;
+        record.op = JOURNAL_UPDATE;
+        record.id = id;
+        if (desc) {
+            record.fields |= FIELD_DESCRIPTION;
+            if (isJournaling()) record.description = *desc;
+            tasks.setDescription(slot, *desc);
+        }
+        if (prio) {
+            tasks.setPriority(slot, static_cast<uint8_t>(*prio));
+            record.fields |= FIELD_PRIORITY;
+            record.priority = static_cast<uint8_t>(*prio);
+        }
+        if (comp) {
+            tasks.setCompleted(slot, *comp);
+            record.fields |= FIELD_COMPLETED;
+            record.completed = *comp;
+        }
+        if (due) {
+            tasks.setDueDate(slot, *due);
+            record.fields |= FIELD_DUE_DATE;
+            record.dueDate = *due;
+        }
+        logChange(record);
+    }
+
+    void TaskList::displayTasks() {
+        TODO_TIME_SCOPE(METRIC_DISPLAY);
         if (tasks.empty()) {
-            std::cout << "No tasks available.\n";
+            *display << "No tasks available.\n";
             return;
         }
 
-        std::cout << std::left << std::setw(5) << "ID"
-            << std::setw(25) << "Description"
-            << std::setw(10) << "Priority"
-            << std::setw(10) << "Status"
-            << std::setw(20) << "Due Date"
-            << std::endl;
+        TaskTable& table = output();
+
+        table.begin(tasks.size());
+        for (size_t slot = 0; slot < tasks.size(); ++slot) {
+            if (!table.row(tasks, slot)) break;
+        }
+        table.end();
+    }
+
+    void TaskList::sortTasksByPriority(bool ascending) {
+        TODO_TIME_SCOPE(METRIC_SORT);
+        // Stable counting sort over the priority column only
+        std::vector<size_t> order;
+        sortSlotsByPriority(tasks.priorityColumn(), ascending, order);
+        tasks.permute(order);
+    }
+
+    void TaskList::sortTasksByDueDate(bool ascending) {
+        TODO_TIME_SCOPE(METRIC_SORT);
+        std::vector<size_t> order;
+        sortSlotsByDueDate(tasks.dueDateColumn(), ascending, order);
+        tasks.permute(order);
+    }
+
+    void TaskList::sortTasksByPriorityThenDueDate(bool priorityAscending, bool dueAscending) {
+        TODO_TIME_SCOPE(METRIC_SORT);
+        std::vector<size_t> order;
+        sortSlotsByPriorityThenDueDate(tasks.priorityColumn(), priorityAscending,
+            tasks.dueDateColumn(), dueAscending, order);
+        tasks.permute(order);
+    }
 
-        for (auto& task : tasks) {
-            char buffer[20];
-            tm timeStruct{};
-            // localtime_s returns 0 on success (MSVC).
-            if (localtime_s(&timeStruct, &task.dueDate) == 0) {
-                strftime(buffer, sizeof(buffer), "%Y-%m-%d", &timeStruct);
+    void TaskList::displayTasksByPriority(bool ascending) {
+        TODO_TIME_SCOPE(METRIC_DISPLAY);
+        if (tasks.empty()) {
+            *display << "No tasks available.\n";
+            return;
+        }
+        const std::set<TaskOrderIndex::PriorityKey>& order = tasks.sortedIndex().byPriority();
+        TaskTable& table = output();
+        table.begin(order.size());
+        if (ascending) {
+            for (const TaskOrderIndex::PriorityKey& key : order) {
+                if (!table.row(tasks, tasks.find(key.second))) break;
             }
-            else {
-                strcpy_s(buffer, "InvalidDate");
+        }
+        else {
+            for (auto it = order.rbegin(); it != order.rend(); ++it) {
+                if (!table.row(tasks, tasks.find(it->second))) break;
             }
+        }
+        table.end();
+    }
 
-            std::cout << std::left << std::setw(5) << task.id
-                << std::setw(25) << task.description
-                << std::setw(10) << priorityToString(task.priority)
-                << std::setw(10) << (task.completed ? "Completed" : "Pending")
-                << std::setw(20) << buffer
-                << std::endl;
+    void TaskList::displayTasksByDueDate(bool ascending) {
+        TODO_TIME_SCOPE(METRIC_DISPLAY);
+        if (tasks.empty()) {
+            *display << "No tasks available.\n";
+            return;
+        }
+        const std::set<TaskOrderIndex::DueKey>& order = tasks.sortedIndex().byDueDate();
+        TaskTable& table = output();
+        table.begin(order.size());
+        if (ascending) {
+            for (const TaskOrderIndex::DueKey& key : order) {
+                if (!table.row(tasks, tasks.find(key.second))) break;
+            }
         }
+        else {
+            for (auto it = order.rbegin(); it != order.rend(); ++it) {
+                if (!table.row(tasks, tasks.find(it->second))) break;
+            }
+        }
+        table.end();
     }
 
-    void Task::sortTasksByPriority(bool ascending) {
-        std::sort(tasks.begin(), tasks.end(),
-            [ascending](const Task& a, const Task& b) {
-                return ascending ? (a.priority < b.priority)
-                    : (a.priority > b.priority);
-            });
+    std::vector<int> TaskList::tasksDueBetween(time_t from, time_t before) {
+        std::vector<int> result;
+        const std::set<TaskOrderIndex::DueKey>& order = tasks.sortedIndex().byDueDate();
+        auto it = order.lower_bound(TaskOrderIndex::DueKey(from, std::numeric_limits<int>::min()));
+        for (; it != order.end() && it->first < before; ++it) {
+            result.push_back(it->second);
+        }
+        return result;
     }
 
-    void Task::sortTasksByDueDate(bool ascending) {
-        std::sort(tasks.begin(), tasks.end(),
-            [ascending](const Task& a, const Task& b) {
-                return ascending ? (a.dueDate < b.dueDate)
-                    : (a.dueDate > b.dueDate);
-            });
+    void TaskList::displayTasksDueBetween(time_t from, time_t before) {
+        std::vector<int> ids = tasksDueBetween(from, before);
+        if (ids.empty()) {
+            *display << "No tasks due in that period.\n";
+            return;
+        }
+        TaskTable& table = output();
+        table.begin(ids.size());
+        for (int id : ids) {
+            if (!table.row(tasks, tasks.find(id))) break;
+        }
+        table.end();
     }
 
-    void Task::filterTasksByStatus(bool completedStatus) {
-        bool foundAny = false;
-        std::cout << std::left << std::setw(5) << "ID"
-            << std::setw(25) << "Description"
-            << std::setw(10) << "Priority"
-            << std::setw(10) << "Status"
-            << std::setw(20) << "Due Date"
-            << std::endl;
-
-        for (auto& task : tasks) {
-            if (task.completed == completedStatus) {
-                foundAny = true;
-                char buffer[20];
-                tm timeStruct{};
-                if (localtime_s(&timeStruct, &task.dueDate) == 0) {
-                    strftime(buffer, sizeof(buffer), "%Y-%m-%d", &timeStruct);
-                }
-                else {
-                    strcpy_s(buffer, "InvalidDate");
-                }
+    std::vector<int> TaskList::searchTasks(std::string_view query) {
+        TODO_TIME_SCOPE(METRIC_SEARCH);
+        std::vector<int> ids;
+        tasks.searchIndex().search(query, ids);
+        return ids;
+    }
 
-                std::cout << std::left << std::setw(5) << task.id
-                    << std::setw(25) << task.description
-                    << std::setw(10) << priorityToString(task.priority)
-                    << std::setw(10) << (task.completed ? "Completed" : "Pending")
-                    << std::setw(20) << buffer
-                    << std::endl;
-            }
+    void TaskList::displaySearchResults(std::string_view query) {
+        std::vector<int> ids = searchTasks(query);
+        if (ids.empty()) {
+            *display << "No tasks match \"" << query << "\".\n";
+            return;
+        }
+        TaskTable& table = output();
+        table.begin(ids.size());
+        for (int id : ids) {
+            if (!table.row(tasks, tasks.find(id))) break;
+        }
+        table.end();
+    }
+
+    TaskQuery TaskList::query() {
+        return TaskQuery(tasks);
+    }
+
+    size_t TaskList::displayQuery(const TaskQuery& query) {
+        size_t shown = 0;
+        TaskTable& table = output();
+        table.begin(0);
+        for (size_t slot : query) {
+            if (!table.row(query.store(), slot)) break;
+            ++shown;
+        }
+        table.end();
+        return shown;
+    }
+
+    size_t TaskList::countMatching(const TaskFilter& filter) {
+        TODO_TIME_SCOPE(METRIC_FILTER);
+        return MyLibrary::countMatching(tasks, filter);
+    }
+
+    size_t TaskList::filterTasks(const TaskFilter& filter) {
+        TODO_TIME_SCOPE(METRIC_FILTER);
+        // Evaluate the whole filter into a bitset first, then visit only the hits
+        std::vector<uint64_t> matches;
+        matchTasks(tasks, filter, matches);
+        std::vector<size_t> slots;
+        collectSlots(matches, slots);
+
+        TaskTable& table = output();
+
+        table.begin(slots.size());
+        for (size_t slot : slots) {
+            if (!table.row(tasks, slot)) break;
         }
-        if (!foundAny) {
-            std::cout << "No tasks found with status: "
+        table.end();
+        return slots.size();
+    }
+
+    void TaskList::filterTasksByStatus(bool completedStatus) {
+        TaskFilter filter;
+        filter.completed = completedStatus;
+        if (filterTasks(filter) == 0) {
+            *display << "No tasks found with status: "
                 << (completedStatus ? "Completed" : "Pending") << std::endl;
         }
     }
 
-    void Task::displayCompletionPercentage() {
+    TaskStats TaskList::getStats(time_t now) {
+        // Everything here is read from the running counters; no column scan
+        const TaskCounters& counters = tasks.counters();
+        TaskStats stats;
+        stats.total = counters.total();
+        stats.completed = counters.completed();
+        stats.pending = stats.total - stats.completed;
+        for (int p = HIGHEST; p <= LOWEST; ++p) {
+            stats.byPriority[p - HIGHEST] = counters.withPriority(static_cast<uint8_t>(p));
+        }
+        stats.overdue = counters.overdue(now);
+        return stats;
+    }
+
+    MetricsSnapshot TaskList::metrics(time_t now) {
+        MetricsSnapshot snapshot = readMetrics();
+        TaskStats stats = getStats(now);
+        const DescriptionPool& pool = tasks.descriptionPool();
+        snapshot.gauges.emplace_back("tasks", static_cast<double>(stats.total));
+        snapshot.gauges.emplace_back("tasks_completed", static_cast<double>(stats.completed));
+        snapshot.gauges.emplace_back("tasks_overdue", static_cast<double>(stats.overdue));
+        snapshot.gauges.emplace_back("description_bytes", static_cast<double>(pool.liveBytes()));
+        snapshot.gauges.emplace_back("description_garbage_bytes", static_cast<double>(pool.garbageBytes()));
+        return snapshot;
+    }
+
+    void TaskList::displayCompletionPercentage() {
         if (tasks.empty()) {
-            std::cout << "No tasks. Completion percentage: 0%\n";
+            *display << "No tasks. Completion percentage: 0%\n";
             return;
         }
-        int completedCount = 0;
-        for (auto& task : tasks) {
-            if (task.completed) {
-                completedCount++;
-            }
-        }
-        double percentage = (static_cast<double>(completedCount) / tasks.size()) * 100.0;
-        std::cout << "Completion Percentage: "
+        double percentage = getStats().completionPercentage();
+        *display << "Completion Percentage: "
             << std::fixed << std::setprecision(2) << percentage << "%\n";
     }
 
+    void TaskList::displayStats() {
+        TaskStats stats = getStats();
+        *display << "Total: " << stats.total
+            << "  Completed: " << stats.completed
+            << "  Pending: " << stats.pending
+            << "  Overdue: " << stats.overdue << "\n";
+        for (int p = HIGHEST; p <= LOWEST; ++p) {
+            *display << std::left << std::setw(10) << priorityToString(static_cast<Priority>(p))
+                << stats.byPriority[p - HIGHEST] << "\n";
+        }
+    }
+
+    size_t TaskList::fireReminders(time_t now, const std::function<void(const Task&)>& handler) {
+        // Take everything due out first, so a task a handler re-arms
+        // (reopens, snoozes to a time <= now) is not seen again here
+        std::vector<int> due;
+        TaskDueQueue& queue = tasks.dueQueue();
+        while (!queue.empty() && queue.topDue() <= now) {
+            due.push_back(queue.topId());
+            queue.pop();
+        }
+        size_t fired = 0;
+        for (int id : due) {
+            // An earlier handler may have deleted or completed it, cleared
+            // its date, or scheduled it again (moved, snoozed, reopened);
+            // then it is back in the queue and fires on a later call
+            if (queue.contains(id)) continue;
+            size_t slot = tasks.find(id);
+            if (slot == TaskIndex::npos || tasks.completed(slot) || tasks.dueDate(slot) == 0) continue;
+            handler(Task(tasks, slot));
+            ++fired;
+        }
+        return fired;
+    }
+
+    time_t TaskList::nextReminder() {
+        TaskDueQueue& queue = tasks.dueQueue();
+        return queue.empty() ? 0 : queue.topDue();
+    }
+
+    /*--------------------- DEFAULT LIST ---------------------------------*/
+    // The static Task API, kept for existing callers
+
+    size_t Task::count() {
+        return TaskList::defaultList().count();
+    }
+
+    Task Task::at(size_t position) {
+        return TaskList::defaultList().at(position);
+    }
+
+    std::optional<Task> Task::find(int id) {
+        return TaskList::defaultList().find(id);
+    }
+
+    void Task::loadTasksFromFile(const std::string& filename) {
+        TaskList::defaultList().loadTasksFromFile(filename);
+    }
+
+    void Task::saveTasksToFile(const std::string& filename) {
+        TaskList::defaultList().saveTasksToFile(filename);
+    }
+
+    std::shared_future<bool> Task::saveTasksToFileAsync(const std::string& filename, std::function<void(bool)> done) {
+        return TaskList::defaultList().saveTasksToFileAsync(filename, std::move(done));
+    }
+
+    bool Task::waitForSaves() {
+        return TaskList::defaultList().waitForSaves();
+    }
+
+    void Task::setSaveInterval(std::chrono::milliseconds interval) {
+        TaskList::setSaveInterval(interval);
+    }
+
+    bool Task::flushSaves() {
+        return TaskList::flushSaves();
+    }
+
+    void Task::setParallelism(size_t threads) {
+        TaskList::setParallelism(threads);
+    }
+
+    void Task::setDescriptionInterning(bool on) {
+        TaskList::defaultList().setDescriptionInterning(on);
+    }
+
+    void Task::loadTasksFromSnapshot(const std::string& filename) {
+        TaskList::defaultList().loadTasksFromSnapshot(filename);
+    }
+
+    void Task::saveTasksToSnapshot(const std::string& filename) {
+        TaskList::defaultList().saveTasksToSnapshot(filename);
+    }
+
+    void Task::setSnapshotCompression(bool on) {
+        TaskList::defaultList().setSnapshotCompression(on);
+    }
+
+    const LoadStats& Task::lastLoadStats() {
+        return TaskList::defaultList().lastLoadStats();
+    }
+
+    void Task::displayLoadStats() {
+        TaskList::defaultList().displayLoadStats();
+    }
+
+    bool Task::openJournal(const std::string& journalFile, const std::string& snapshotFile, uint64_t compactBytes) {
+        return TaskList::defaultList().openJournal(journalFile, snapshotFile, compactBytes);
+    }
+
+    bool Task::openJournalForAppend(const std::string& journalFile, const std::string& snapshotFile) {
+        return TaskList::defaultList().openJournalForAppend(journalFile, snapshotFile);
+    }
+
+    bool Task::isAppendOnly() {
+        return TaskList::defaultList().isAppendOnly();
+    }
+
+    bool Task::isJournaling() {
+        return TaskList::defaultList().isJournaling();
+    }
+
+    void Task::syncJournal() {
+        TaskList::defaultList().syncJournal();
+    }
+
+    void Task::closeJournal() {
+        TaskList::defaultList().closeJournal();
+    }
+
+    void Task::addTask(std::string_view desc, Priority prio, time_t due) {
+        TaskList::defaultList().addTask(desc, prio, due);
+    }
+
+    int Task::emplaceTask(std::string_view desc, Priority prio, time_t due, bool completed) {
+        return TaskList::defaultList().emplaceTask(desc, prio, due, completed);
+    }
+
+    void Task::reserveTasks(size_t count, size_t textBytes) {
+        TaskList::defaultList().reserveTasks(count, textBytes);
+    }
+
+    void Task::deleteTask(int id) {
+        TaskList::defaultList().deleteTask(id);
+    }
+
+    void Task::setDeleteMode(DeleteMode mode) {
+        TaskList::defaultList().setDeleteMode(mode);
+    }
+
+    std::vector<MutationResult> Task::applyBatch(const std::vector<Mutation>& batch) {
+        return TaskList::defaultList().applyBatch(batch);
+    }
+
+    ConcurrentTaskStore& Task::beginConcurrentMode(size_t shards) {
+        return TaskList::defaultList().beginConcurrentMode(shards);
+    }
+
+    void Task::endConcurrentMode() {
+        TaskList::defaultList().endConcurrentMode();
+    }
+
+    bool Task::isConcurrent() {
+        return TaskList::defaultList().isConcurrent();
+    }
+
+    void Task::updateTask(int id, std::optional<std::string_view> desc, std::optional<Priority> prio, std::optional<bool> comp, std::optional<time_t> due) {
+        TaskList::defaultList().updateTask(id, desc, prio, comp, due);
+    }
+
+    void Task::displayTasks() {
+        TaskList::defaultList().displayTasks();
+    }
+
+    void Task::displayTasks(size_t offset) {
+        TaskList::defaultList().displayTasks(offset);
+    }
+
+    void Task::setDisplayLimit(size_t rows) {
+        TaskList::defaultList().setDisplayLimit(rows);
+    }
+
+    void Task::setOutput(std::ostream& out) {
+        TaskList::defaultList().setOutput(out);
+    }
+
+    void Task::sortTasksByPriority(bool ascending) {
+        TaskList::defaultList().sortTasksByPriority(ascending);
+    }
+
+    void Task::sortTasksByDueDate(bool ascending) {
+        TaskList::defaultList().sortTasksByDueDate(ascending);
+    }
+
+    void Task::sortTasksByPriorityThenDueDate(bool priorityAscending, bool dueAscending) {
+        TaskList::defaultList().sortTasksByPriorityThenDueDate(priorityAscending, dueAscending);
+    }
+
+    void Task::displayTasksByPriority(bool ascending) {
+        TaskList::defaultList().displayTasksByPriority(ascending);
+    }
+
+    void Task::displayTasksByDueDate(bool ascending) {
+        TaskList::defaultList().displayTasksByDueDate(ascending);
+    }
+
+    std::vector<int> Task::tasksDueBetween(time_t from, time_t before) {
+        return TaskList::defaultList().tasksDueBetween(from, before);
+    }
+
+    void Task::displayTasksDueBetween(time_t from, time_t before) {
+        TaskList::defaultList().displayTasksDueBetween(from, before);
+    }
+
+    void Task::filterTasksByStatus(bool completedStatus) {
+        TaskList::defaultList().filterTasksByStatus(completedStatus);
+    }
+
+    std::vector<int> Task::searchTasks(std::string_view query) {
+        return TaskList::defaultList().searchTasks(query);
+    }
+
+    void Task::displaySearchResults(std::string_view query) {
+        TaskList::defaultList().displaySearchResults(query);
+    }
+
+    TaskQuery Task::query() {
+        return TaskList::defaultList().query();
+    }
+
+    size_t Task::displayQuery(const TaskQuery& query) {
+        return TaskList::defaultList().displayQuery(query);
+    }
+
+    size_t Task::countMatching(const TaskFilter& filter) {
+        return TaskList::defaultList().countMatching(filter);
+    }
+
+    size_t Task::filterTasks(const TaskFilter& filter) {
+        return TaskList::defaultList().filterTasks(filter);
+    }
+
+    void Task::displayCompletionPercentage() {
+        TaskList::defaultList().displayCompletionPercentage();
+    }
+
+    TaskStats Task::getStats(time_t now) {
+        return TaskList::defaultList().getStats(now);
+    }
+
+    void Task::displayStats() {
+        TaskList::defaultList().displayStats();
+    }
+
+    size_t Task::fireReminders(time_t now, const std::function<void(const Task&)>& handler) {
+        return TaskList::defaultList().fireReminders(now, handler);
+    }
+
+    time_t Task::nextReminder() {
+        return TaskList::defaultList().nextReminder();
+    }
+
+    MetricsSnapshot Task::metrics(time_t now) {
+        return TaskList::defaultList().metrics(now);
+    }
+
 } // end namespace MyLibrary
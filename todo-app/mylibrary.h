@@ -11,9 +11,24 @@
 #include <iomanip>
 #include <optional>
 #include <limits>
+#include <string_view>
+#include <chrono>
+#include <future>
+#include <functional>
+#include <set>
+#include <cstring>
 
-// For MSVC localtime_s usage (optional)
-#include <cstring>  
+#include "taskstore.h"
+#include "taskkernels.h"
+#include "tasksort.h"
+#include "threadpool.h"
+#include "journal.h"
+#include "fileio.h"
+#include "taskdate.h"
+#include "tasktable.h"
+#include "taskquery.h"
+#include "taskshards.h"
+#include "taskmetrics.h"
 
 namespace MyLibrary
 {
@@ -46,39 +61,419 @@ namespace MyLibrary
      */
     time_t promptForDueDate();
 
+    /**
+     * How deleteTask closes the gap. DELETE_SHIFT keeps the remaining tasks
+     * in order; DELETE_SWAP moves the last task into the gap, which is O(1)
+     * but changes the display order.
+     */
+    enum DeleteMode {
+        DELETE_SHIFT,
+        DELETE_SWAP
+    };
+
+    enum MutationOp {
+        MUTATION_ADD,       // new task from description/priority/dueDate
+        MUTATION_UPDATE,    // set whichever fields are present
+        MUTATION_COMPLETE,  // mark task id as completed
+        MUTATION_DELETE
+    };
+
+    /**
+     * One entry of a Task::applyBatch call. id is ignored for adds, which
+     * need description and priority; a missing dueDate means "none" (0).
+     * The description view only has to stay valid for the call.
+     */
+    struct Mutation {
+        MutationOp op = MUTATION_UPDATE;
+        int id = 0;
+        std::optional<std::string_view> description;
+        std::optional<Priority> priority;
+        std::optional<bool> completed;
+        std::optional<time_t> dueDate;
+    };
+
+    enum MutationStatus {
+        MUTATION_OK,
+        MUTATION_NOT_FOUND,  // no such task, or deleted earlier in the batch
+        MUTATION_INVALID     // empty description or priority out of range
+    };
+
+    struct MutationResult {
+        MutationStatus status = MUTATION_OK;
+        int id = 0;  // the task touched; the new ID for a successful add
+    };
+
+    /**
+     * Timing of the most recent loadTasksFromFile call.
+     */
+    struct LoadStats {
+        size_t tasksLoaded = 0;
+        size_t bytesRead = 0;
+        double seconds = 0.0;
+    };
+
+    /**
+     * Lightweight view of one task in a TaskList's store.
+     * All task data lives in the store's columns; a Task only remembers
+     * which slot it refers to, so it is invalidated by anything that moves
+     * slots (delete, sort, load).
+     *
+     * The static methods are the original single-list API. Each one
+     * forwards to the same method of TaskList::defaultList().
+     */
     class Task {
     private:
-        int id;
-        std::string description;
-        Priority priority;
-        bool completed;
-        time_t dueDate;
+        friend class TaskList;
 
-        static int nextId;
-        static std::vector<Task> tasks;
+        const TaskStore* store;
+        size_t slot;
 
-        // Validate description & priority
-        static bool validateTask(const std::string& desc, Priority prio);
+        Task(const TaskStore& store, size_t slot);
 
     public:
-        // Constructor
-        Task(const std::string& desc, Priority prio, time_t due);
+        // ---------- Task View ----------
+        int getId() const { return store->id(slot); }
+        std::string_view getDescription() const { return store->description(slot); }
+        Priority getPriority() const { return static_cast<Priority>(store->priority(slot)); }
+        bool isCompleted() const { return store->completed(slot); }
+        time_t getDueDate() const { return store->dueDate(slot); }
 
-        // ---------- Static Methods ----------
+        // ---------- Default List ----------
+        static size_t count();
+        static Task at(size_t position);
+        static std::optional<Task> find(int id);
         static void loadTasksFromFile(const std::string& filename);
         static void saveTasksToFile(const std::string& filename);
-        static void addTask(const std::string& desc, Priority prio, time_t due);
+        static std::shared_future<bool> saveTasksToFileAsync(const std::string& filename,
+            std::function<void(bool)> done = {});
+        static bool waitForSaves();
+        static void setSaveInterval(std::chrono::milliseconds interval);
+        static bool flushSaves();
+        static void setParallelism(size_t threads);
+        static void setDescriptionInterning(bool on);
+        static void loadTasksFromSnapshot(const std::string& filename);
+        static void saveTasksToSnapshot(const std::string& filename);
+        static void setSnapshotCompression(bool on);
+        static const LoadStats& lastLoadStats();
+        static void displayLoadStats();
+        static bool openJournal(const std::string& journalFile,
+            const std::string& snapshotFile,
+            uint64_t compactBytes = 64ull * 1024 * 1024);
+        static bool openJournalForAppend(const std::string& journalFile, const std::string& snapshotFile);
+        static bool isAppendOnly();
+        static bool isJournaling();
+        static void syncJournal();
+        static void closeJournal();
+        static void addTask(std::string_view desc, Priority prio, time_t due);
+        static int emplaceTask(std::string_view desc, Priority prio, time_t due, bool completed = false);
+        static void reserveTasks(size_t count, size_t textBytes = 0);
         static void deleteTask(int id);
+        static void setDeleteMode(DeleteMode mode);
+        static std::vector<MutationResult> applyBatch(const std::vector<Mutation>& batch);
+        static ConcurrentTaskStore& beginConcurrentMode(size_t shards = 64);
+        static void endConcurrentMode();
+        static bool isConcurrent();
         static void updateTask(int id,
-            std::optional<std::string> desc = {},
+            std::optional<std::string_view> desc = {},
             std::optional<Priority> prio = {},
             std::optional<bool> comp = {},
             std::optional<time_t> due = {});
         static void displayTasks();
+        static void displayTasks(size_t offset);
+        static void setDisplayLimit(size_t rows);
+        static void setOutput(std::ostream& out);
         static void sortTasksByPriority(bool ascending = true);
         static void sortTasksByDueDate(bool ascending = true);
+        static void sortTasksByPriorityThenDueDate(bool priorityAscending = true, bool dueAscending = true);
+        static void displayTasksByPriority(bool ascending = true);
+        static void displayTasksByDueDate(bool ascending = true);
+        static std::vector<int> tasksDueBetween(time_t from, time_t before);
+        static void displayTasksDueBetween(time_t from, time_t before);
         static void filterTasksByStatus(bool completedStatus);
+        static std::vector<int> searchTasks(std::string_view query);
+        static void displaySearchResults(std::string_view query);
+        static TaskQuery query();
+        static size_t displayQuery(const TaskQuery& query);
+        static size_t countMatching(const TaskFilter& filter);
+        static size_t filterTasks(const TaskFilter& filter);
         static void displayCompletionPercentage();
+        static TaskStats getStats(time_t now = std::time(nullptr));
+        static void displayStats();
+        static size_t fireReminders(time_t now, const std::function<void(const Task&)>& handler);
+        static time_t nextReminder();
+        static MetricsSnapshot metrics(time_t now = std::time(nullptr));
+    };
+
+    /**
+     * One independent task list: its own store, indexes, ID counter,
+     * journal and (optionally) file. Lists share the worker threads and
+     * the group-commit save writer, so a process can hold many of them;
+     * an idle list costs little more than its tasks.
+     *
+     * A list is used from one thread at a time (see beginConcurrentMode
+     * for multi-threaded access to one list).
+     */
+    class TaskList {
+    public:
+        // file is what load() and save() use; it may be left empty
+        explicit TaskList(std::string file = std::string());
+        ~TaskList();
+
+        TaskList(const TaskList&) = delete;
+        TaskList& operator=(const TaskList&) = delete;
+
+        // The list behind the static Task API
+        static TaskList& defaultList();
+
+        const std::string& file() const { return fileName; }
+        void setFile(std::string file) { fileName = std::move(file); }
+        // Load from / save to file(); false if no file is set
+        bool load();
+        bool save();
+
+        size_t count() const;
+        // View of the task in a given display position (0 .. count()-1)
+        Task at(size_t position);
+        // View of the task with a given ID, if there is one
+        std::optional<Task> find(int id);
+
+        void loadTasksFromFile(const std::string& filename);
+        void saveTasksToFile(const std::string& filename);
+        /**
+         * Save on a background thread and return at once, from a
+         * copy-on-write snapshot of the rows (see TaskColumns); later edits
+         * do not reach this save. The
+         * future (and done, if given, on the saving thread) reports whether
+         * the file was committed. Saves finish in the order they start.
+         */
+        std::shared_future<bool> saveTasksToFileAsync(const std::string& filename,
+            std::function<void(bool)> done = {});
+        // Wait for every background save; false if the last one failed
+        bool waitForSaves();
+        /**
+         * Group commit: with a non-zero interval saveTasksToFile only queues
+         * the new contents, and a background writer commits each file at
+         * most once per interval. Zero (the default) saves synchronously.
+         */
+        static void setSaveInterval(std::chrono::milliseconds interval);
+        // Wait until every queued save is on disk; false if one failed
+        static bool flushSaves();
+        // Threads used for sorting, filtering and saving; 0 = all cores
+        static void setParallelism(size_t threads);
+        // Store each distinct description once (see DescriptionPool)
+        void setDescriptionInterning(bool on);
+        void loadTasksFromSnapshot(const std::string& filename);
+        void saveTasksToSnapshot(const std::string& filename);
+        /**
+         * Write snapshots (including journal compaction) as compressed
+         * blocks with delta-coded IDs and due dates; see tasksnapshot.cpp.
+         * Loading reads either format.
+         */
+        void setSnapshotCompression(bool on);
+        const LoadStats& lastLoadStats() const;
+        void displayLoadStats();
+
+        /**
+         * Switch to journal mode: replay journalFile onto the tasks already
+         * loaded from snapshotFile, then log every add/update/delete to it.
+         * Once the journal grows past compactBytes it is folded into a fresh
+         * snapshot on a background thread. Starting one costs the change
+         * that triggers it an fsync; the next change made while it runs
+         * copies the columns (see TaskColumns). A compaction left
+         * unfinished by a crash is completed here, synchronously. An add
+         * whose ID is already taken is reported and skipped.
+         */
+        bool openJournal(const std::string& journalFile,
+            const std::string& snapshotFile,
+            uint64_t compactBytes = 64ull * 1024 * 1024);
+        /**
+         * Journal mode without loading anything: only the snapshot header
+         * and the journal's IDs are read, so adds get fresh IDs and every
+         * change is appended blind. Meant for scripts that only write.
+         * Updates and deletes are logged without knowing whether the task
+         * exists (replay skips missing ones), nothing can be listed, and
+         * the journal is not compacted until it is next opened normally.
+         */
+        bool openJournalForAppend(const std::string& journalFile, const std::string& snapshotFile);
+        bool isAppendOnly() const { return appendOnly; }
+        bool isJournaling() const;
+        // Make all logged changes durable
+        void syncJournal();
+        // Wait for any running compaction, fold the journal into the
+        // snapshot, and leave journal mode
+        void closeJournal();
+
+        void addTask(std::string_view desc, Priority prio, time_t due);
+        /**
+         * Add a task and return its ID, or 0 if it is invalid. The text is
+         * copied straight into the description arena; nothing else allocates
+         * unless the journal is open.
+         */
+        int emplaceTask(std::string_view desc, Priority prio, time_t due, bool completed = false);
+        // Make room for count tasks holding textBytes of descriptions in total
+        void reserveTasks(size_t count, size_t textBytes = 0);
+        void deleteTask(int id);
+        void setDeleteMode(DeleteMode mode);
+        /**
+         * Apply mutations in order and return one result per entry instead
+         * of printing warnings. Every ID is looked up once, deletes are
+         * removed from the store together at the end, and the journal gets
+         * a single write for the whole batch.
+         */
+        std::vector<MutationResult> applyBatch(const std::vector<Mutation>& batch);
+        /**
+         * Move the tasks into a ConcurrentTaskStore that any number of
+         * threads may read and write at once. Until endConcurrentMode the
+         * rest of this list's API must be left alone, and changes made
+         * through the store are not journaled one by one.
+         */
+        ConcurrentTaskStore& beginConcurrentMode(size_t shards = 64);
+        // Copy the tasks back, ordered by ID; with the journal open they
+        // are folded into a new snapshot
+        void endConcurrentMode();
+        bool isConcurrent() const;
+        void updateTask(int id,
+            std::optional<std::string_view> desc = {},
+            std::optional<Priority> prio = {},
+            std::optional<bool> comp = {},
+            std::optional<time_t> due = {});
+        void displayTasks();
+        // Same, starting at the given display position (for paging)
+        void displayTasks(size_t offset);
+        // Most rows any listing prints before "... N more"; 0 = all
+        void setDisplayLimit(size_t rows);
+        // Stream every listing and report is written to (std::cout by default)
+        void setOutput(std::ostream& out);
+        // Stable, linear-time reorders of the stored list
+        void sortTasksByPriority(bool ascending = true);
+        void sortTasksByDueDate(bool ascending = true);
+        void sortTasksByPriorityThenDueDate(bool priorityAscending = true, bool dueAscending = true);
+
+        /**
+         * Sorted views served from the maintained secondary indexes; the
+         * stored order is left alone. Ties are broken by task ID.
+         */
+        void displayTasksByPriority(bool ascending = true);
+        void displayTasksByDueDate(bool ascending = true);
+        // IDs of tasks due in [from, before), earliest first
+        std::vector<int> tasksDueBetween(time_t from, time_t before);
+        void displayTasksDueBetween(time_t from, time_t before);
+        void filterTasksByStatus(bool completedStatus);
+        /**
+         * IDs (ascending) of tasks whose description has every word of
+         * query; "word*" matches by prefix. Uses the inverted index, which
+         * is built on the first search and then kept current.
+         */
+        std::vector<int> searchTasks(std::string_view query);
+        void displaySearchResults(std::string_view query);
+        /**
+         * Start a lazy query over the tasks, e.g.
+         * list.query().pending().priorityAtMost(HIGH).orderBy(ORDER_DUE_DATE).limit(10).
+         * The result is invalidated by any change to the task list.
+         */
+        TaskQuery query();
+        // Print the rows of a query; returns how many were shown
+        size_t displayQuery(const TaskQuery& query);
+        // Number of tasks matching filter, without displaying them
+        size_t countMatching(const TaskFilter& filter);
+        // Display the tasks matching filter; returns how many were shown
+        size_t filterTasks(const TaskFilter& filter);
+        void displayCompletionPercentage();
+
+        /**
+         * Totals, per-priority counts and overdue count, read from counters
+         * that every mutation keeps current. Cheap enough to poll.
+         */
+        TaskStats getStats(time_t now = std::time(nullptr));
+        void displayStats();
+
+        /**
+         * Call handler for every pending task that has come due by now,
+         * earliest first, from the maintained due-date queue: O(log n) per
+         * task fired, nothing for the rest. Each task fires once per due
+         * date; moving the date or reopening the task schedules it again.
+         * The handler may change the list; a task it schedules again
+         * fires on a later call, not this one. Returns how many fired.
+         */
+        size_t fireReminders(time_t now, const std::function<void(const Task&)>& handler);
+        // Earliest due date still waiting to fire, or 0 if there is none
+        time_t nextReminder();
+
+        /**
+         * The process-wide timers and counters (see taskmetrics.h) plus
+         * gauges for this list: task counts and description bytes. The
+         * timers and counters read zero unless built with
+         * TODO_ENABLE_METRICS; the gauges are always filled in.
+         */
+        MetricsSnapshot metrics(time_t now = std::time(nullptr));
+
+    private:
+        // Validate description & priority
+        static bool validateTask(std::string_view desc, Priority prio);
+        // Same check without the error messages
+        static bool isValidTask(std::string_view desc, Priority prio);
+        // Non-empty, one line and free of the '|' the task file uses
+        static bool isValidDescription(std::string_view desc);
+
+        // Append a task with a known ID and return its slot
+        size_t insertTask(int id, std::string_view desc, Priority prio, bool comp, time_t due);
+        // Append one row of the text format
+        // Rows is TaskStore or TaskColumns (mylibrary.cpp only)
+        template <typename Rows>
+        static void appendTaskRow(std::string& out, const Rows& source, size_t slot);
+        // Text format of source, handed to sink a batch of chunks at a time
+        // (batch 0 = all at once); sink may take the strings
+        template <typename Rows>
+        static void formatTasks(const Rows& source, int next, size_t batch,
+            const std::function<void(std::vector<std::string>&)>& sink);
+        // With group commit the text is only queued, and the result is
+        // known once the writer commits it: wait says whether to block
+        // for that or report success at once
+        template <typename Rows>
+        static bool writeTasksFile(const Rows& source, int next, const std::string& filename, bool wait);
+        // Table output for listings, created on first use
+        TaskTable& output();
+
+        // Binary snapshot support (tasksnapshot.cpp)
+        static bool isSnapshotData(std::string_view data);
+        bool loadSnapshotData(std::string_view data);
+        bool loadCompressedSnapshot(std::string_view data);
+        static std::vector<char> buildSnapshot(const TaskColumns& source, int next, uint64_t seq,
+            bool compressed = false);
+        static bool writeSnapshot(const std::string& filename, const std::vector<char>& buffer);
+        // nextId and journal seq from a snapshot's header; true if the file is missing
+        static bool readSnapshotHeader(const std::string& filename, int& next, uint64_t& seq);
+        void finishLoadStats(std::chrono::steady_clock::time_point start, size_t bytes);
+
+        // Write-ahead journal support (taskjournal.cpp)
+        void logChange(JournalRecord& record);
+        void logChanges(std::vector<JournalRecord>& records);
+        void applyJournalRecord(const JournalRecord& record);
+        void compactJournal();
+        // applyBatch for append-only mode: log each change without a lookup
+        std::vector<MutationResult> appendBatch(const std::vector<Mutation>& batch);
+
+        static GroupCommitWriter saveWriter;  // shared by every list
+
+        std::string fileName;
+        int nextId = 1;
+        DeleteMode deleteMode = DELETE_SHIFT;
+        TaskStore tasks;
+        LoadStats loadStats;
+        std::ostream* display = &std::cout;
+        std::unique_ptr<TaskTable> listing;
+        size_t displayLimit = 0;
+        std::unique_ptr<ConcurrentTaskStore> concurrent;
+
+        Journal journal;
+        uint64_t journalSeq = 0;          // last change applied to the store
+        std::string journalSnapshot;      // snapshot the journal is replayed onto
+        uint64_t compactThreshold = 0;
+        bool compressSnapshots = false;   // see setSnapshotCompression
+        bool appendOnly = false;          // see openJournalForAppend
+        std::string lostJournal;          // journal compaction could not reopen
+        std::future<void> compaction;
+        std::shared_future<bool> lastSave;  // newest background save
     };
 
 } // end namespace MyLibrary
@@ -0,0 +1,217 @@
+#include "taskcommands.h"
+
+#include <charconv>
+
+namespace MyLibrary
+{
+    namespace
+    {
+        // Most changes applied in one batch
+        const size_t kMaxBatch = 4096;
+
+        bool isSpace(char c) {
+            return c == ' ' || c == '\t' || c == '\r';
+        }
+
+        std::string_view trim(std::string_view text) {
+            while (!text.empty() && isSpace(text.front())) text.remove_prefix(1);
+            while (!text.empty() && isSpace(text.back())) text.remove_suffix(1);
+            return text;
+        }
+
+        // Split off the next space-separated word, advancing rest
+        std::string_view nextWord(std::string_view& rest) {
+            rest = trim(rest);
+            size_t end = 0;
+            while (end < rest.size() && !isSpace(rest[end])) ++end;
+            std::string_view word = rest.substr(0, end);
+            rest = trim(rest.substr(end));
+            return word;
+        }
+
+        template <typename T>
+        bool parseWhole(std::string_view text, T& out) {
+            if (text.empty()) return false;
+            auto result = std::from_chars(text.data(), text.data() + text.size(), out);
+            return result.ec == std::errc() && result.ptr == text.data() + text.size();
+        }
+
+        bool parsePriority(std::string_view text, Priority& out) {
+            int value = 0;
+            if (!parseWhole(text, value) || value < HIGHEST || value > LOWEST) return false;
+            out = static_cast<Priority>(value);
+            return true;
+        }
+
+        bool parseDue(std::string_view text, time_t& out) {
+            if (text == "-") {
+                out = 0;
+                return true;
+            }
+            if (text.size() == 10 && text[4] == '-' && text[7] == '-') {
+                int year = 0, month = 0, day = 0;
+                if (!parseWhole(text.substr(0, 4), year) || !parseWhole(text.substr(5, 2), month)
+                    || !parseWhole(text.substr(8, 2), day)) {
+                    return false;
+                }
+                tm timeStruct = {};
+                timeStruct.tm_year = year - 1900;
+                timeStruct.tm_mon = month - 1;
+                timeStruct.tm_mday = day;
+                timeStruct.tm_hour = 12;  // noon, as promptForDueDate does
+                out = mktime(&timeStruct);
+                return out != -1;
+            }
+            return parseWhole(text, out);
+        }
+    }
+
+    TaskCommandRunner::TaskCommandRunner(TaskList& list, std::ostream& out)
+        : list(list), out(out)
+    {
+    }
+
+    void TaskCommandRunner::run(std::istream& in) {
+        std::string line;
+        while (std::getline(in, line)) execute(line);
+        finish();
+    }
+
+    std::string_view TaskCommandRunner::keep(std::string_view text) {
+        texts.emplace_back(text);
+        return texts.back();
+    }
+
+    void TaskCommandRunner::fail(std::string_view reason) {
+        // Earlier changes answer first, so output stays in command order
+        finish();
+        out << "error " << lineNumber << ": " << reason << '\n';
+        ++failed;
+    }
+
+    void TaskCommandRunner::queue(const Mutation& change) {
+        pending.push_back(change);
+        pendingLines.push_back(lineNumber);
+        if (pending.size() >= kMaxBatch) finish();
+    }
+
+    void TaskCommandRunner::finish() {
+        if (pending.empty()) return;
+        std::vector<MutationResult> results = list.applyBatch(pending);
+        for (size_t i = 0; i < results.size(); ++i) {
+            const MutationResult& result = results[i];
+            if (result.status == MUTATION_OK) {
+                out << "ok " << result.id << '\n';
+                ++changed;
+                continue;
+            }
+            out << "error " << pendingLines[i] << ": "
+                << (result.status == MUTATION_NOT_FOUND ? "no task with ID " + std::to_string(result.id)
+                    : std::string("invalid description or priority")) << '\n';
+            ++failed;
+        }
+        pending.clear();
+        pendingLines.clear();
+        texts.clear();
+    }
+
+    bool TaskCommandRunner::parseSet(int id, std::string_view field, std::string_view value, Mutation& change) {
+        change.op = MUTATION_UPDATE;
+        change.id = id;
+        if (field == "description") {
+            if (value.empty()) return false;
+            change.description = keep(value);
+            return true;
+        }
+        if (field == "priority") {
+            Priority prio;
+            if (!parsePriority(value, prio)) return false;
+            change.priority = prio;
+            return true;
+        }
+        if (field == "due") {
+            time_t due;
+            if (!parseDue(value, due)) return false;
+            change.dueDate = due;
+            return true;
+        }
+        if (field == "completed") {
+            if (value != "0" && value != "1") return false;
+            change.completed = value == "1";
+            return true;
+        }
+        return false;
+    }
+
+    void TaskCommandRunner::execute(std::string_view line) {
+        ++lineNumber;
+        std::string_view rest = trim(line);
+        if (rest.empty() || rest.front() == '#') return;
+        std::string_view command = nextWord(rest);
+
+        if (command == "add") {
+            Mutation change;
+            change.op = MUTATION_ADD;
+            Priority prio;
+            time_t due;
+            if (!parsePriority(nextWord(rest), prio)) return fail("priority must be 1 to 5");
+            if (!parseDue(nextWord(rest), due)) return fail("due date must be YYYY-MM-DD, seconds or -");
+            if (rest.empty()) return fail("description cannot be empty");
+            change.priority = prio;
+            change.dueDate = due;
+            change.description = keep(rest);
+            return queue(change);
+        }
+        if (command == "done" || command == "delete" || command == "set") {
+            Mutation change;
+            int id = 0;
+            if (!parseWhole(nextWord(rest), id)) return fail("expected a task ID");
+            change.id = id;
+            if (command == "done") change.op = MUTATION_COMPLETE;
+            else if (command == "delete") change.op = MUTATION_DELETE;
+            else {
+                std::string_view field = nextWord(rest);
+                if (!parseSet(id, field, rest, change)) return fail("usage: set ID description|priority|due|completed VALUE");
+            }
+            if (command != "set" && !rest.empty()) return fail("unexpected text after the ID");
+            return queue(change);
+        }
+
+        // Everything else reads the list, so pending changes go in first
+        finish();
+        if (command == "sync") {
+            list.syncJournal();
+            return;
+        }
+        if (command == "metrics") {
+            if (rest == "json") writeJsonMetrics(out, list.metrics());
+            else if (rest.empty()) writePrometheusMetrics(out, list.metrics());
+            else fail("usage: metrics [json]");
+            return;
+        }
+        if (list.isAppendOnly()) return fail("only changes are allowed in append-only mode");
+        if (command == "list") {
+            list.displayTasks();
+        }
+        else if (command == "search") {
+            list.displaySearchResults(rest);
+        }
+        else if (command == "stats") {
+            list.displayStats();
+        }
+        else if (command == "remind") {
+            if (!rest.empty()) return fail("unexpected text after remind");
+            list.fireReminders(std::time(nullptr), [this](const Task& task) {
+                out << "due " << task.getId() << ' ' << dates.format(task.getDueDate())
+                    << ' ' << task.getDescription() << '\n';
+            });
+        }
+        else if (command == "save") {
+            if (!list.save()) return fail("the list has no file");
+        }
+        else {
+            fail("unknown command " + std::string(command));
+        }
+    }
+
+} // end namespace MyLibrary
@@ -0,0 +1,74 @@
+#pragma once
+#ifndef TASKCOMMANDS_H
+#define TASKCOMMANDS_H
+
+#include <deque>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstddef>
+
+#include "mylibrary.h"
+#include "taskdate.h"
+
+namespace MyLibrary
+{
+    /**
+     * Runs the batch line protocol against a TaskList: one command per
+     * line, no prompts. Blank lines and lines starting with '#' are skipped.
+     *
+     *   add PRIORITY DUE DESCRIPTION...     -> ok <new id>
+     *   done ID | delete ID                 -> ok <id>
+     *   set ID description TEXT...          -> ok <id>
+     *   set ID priority|due|completed VALUE
+     *   list | search QUERY... | stats | save | sync
+     *   remind                              -> due <id> <YYYY-MM-DD> <description>
+     *                                          for each task come due since
+     *                                          the last remind
+     *   metrics [json]                      -> timers, counters and gauges in
+     *                                          Prometheus text format, or JSON
+     *
+     * DUE is YYYY-MM-DD (local noon, like the interactive prompt), seconds
+     * since the epoch, or "-" for none. A failed command prints
+     * "error <line>: <reason>".
+     *
+     * Consecutive changes are collected and handed to TaskList::applyBatch
+     * together; results are still printed in command order.
+     */
+    class TaskCommandRunner {
+    public:
+        TaskCommandRunner(TaskList& list, std::ostream& out);
+
+        // Run every line of in, then apply what is still pending
+        void run(std::istream& in);
+        // Run one line; changes may stay pending until finish()
+        void execute(std::string_view line);
+        void finish();
+
+        size_t failures() const { return failed; }
+        // Changes that were applied successfully
+        size_t changes() const { return changed; }
+
+    private:
+        void queue(const Mutation& change);
+        void fail(std::string_view reason);
+        bool parseSet(int id, std::string_view field, std::string_view value, Mutation& change);
+        // Descriptions stay put in a deque while the batch points at them
+        std::string_view keep(std::string_view text);
+
+        TaskList& list;
+        std::ostream& out;
+        std::vector<Mutation> pending;
+        std::vector<size_t> pendingLines;
+        std::deque<std::string> texts;
+        DateFormatter dates;
+        size_t lineNumber = 0;
+        size_t failed = 0;
+        size_t changed = 0;
+    };
+
+} // end namespace MyLibrary
+
+#endif // TASKCOMMANDS_H
@@ -0,0 +1,154 @@
+#include "taskcompress.h"
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace MyLibrary
+{
+    namespace
+    {
+        const size_t kMinMatch = 4;
+        // The format ends every block with literals: the last match starts
+        // at least kMatchLimit bytes and ends kLastLiterals bytes before the end
+        const size_t kLastLiterals = 5;
+        const size_t kMatchLimit = 12;
+        const size_t kMaxOffset = 65535;
+        const unsigned kHashBits = 14;
+        // After this many misses in a row, start skipping ahead faster
+        const unsigned kSkipTrigger = 6;
+
+        uint32_t read32(const uint8_t* p) {
+            uint32_t value;
+            std::memcpy(&value, p, sizeof(value));
+            return value;
+        }
+
+        uint32_t hash4(uint32_t sequence) {
+            return (sequence * 2654435761u) >> (32 - kHashBits);
+        }
+
+        // Lengths past 15 continue in bytes of 255 and a final remainder
+        uint8_t* putLength(uint8_t* out, size_t length) {
+            while (length >= 255) {
+                *out++ = 255;
+                length -= 255;
+            }
+            *out++ = static_cast<uint8_t>(length);
+            return out;
+        }
+
+        bool getLength(const uint8_t*& in, const uint8_t* end, size_t& length) {
+            uint8_t byte;
+            do {
+                if (in == end) return false;
+                byte = *in++;
+                length += byte;
+            } while (byte == 255);
+            return true;
+        }
+
+        uint8_t* putSequence(uint8_t* out, const uint8_t* literals, size_t literalCount,
+            size_t offset, size_t matchLength)
+        {
+            uint8_t* token = out++;
+            size_t matchCode = matchLength - kMinMatch;
+            *token = static_cast<uint8_t>((literalCount < 15 ? literalCount : 15) << 4);
+            if (literalCount >= 15) out = putLength(out, literalCount - 15);
+            std::memcpy(out, literals, literalCount);
+            out += literalCount;
+            if (matchLength == 0) return out;  // closing literals
+
+            *out++ = static_cast<uint8_t>(offset);
+            *out++ = static_cast<uint8_t>(offset >> 8);
+            *token |= static_cast<uint8_t>(matchCode < 15 ? matchCode : 15);
+            if (matchCode >= 15) out = putLength(out, matchCode - 15);
+            return out;
+        }
+    }
+
+    size_t compressBound(size_t size) {
+        return size + size / 255 + 16;
+    }
+
+    size_t compressBlock(const char* src, size_t size, char* dst) {
+        const uint8_t* in = reinterpret_cast<const uint8_t*>(src);
+        uint8_t* out = reinterpret_cast<uint8_t*>(dst);
+        size_t anchor = 0;
+
+        if (size > kMatchLimit) {
+            // Positions are stored plus one so zero means empty
+            std::vector<uint32_t> table(size_t(1) << kHashBits, 0);
+            size_t limit = size - kMatchLimit;
+            size_t pos = 0;
+            unsigned misses = 0;
+            while (pos <= limit) {
+                uint32_t sequence = read32(in + pos);
+                uint32_t& entry = table[hash4(sequence)];
+                size_t candidate = entry;
+                entry = static_cast<uint32_t>(pos + 1);
+                if (candidate == 0 || pos - (candidate - 1) > kMaxOffset
+                    || read32(in + candidate - 1) != sequence) {
+                    pos += 1 + (misses++ >> kSkipTrigger);
+                    continue;
+                }
+                misses = 0;
+                size_t match = candidate - 1;
+                size_t length = kMinMatch;
+                size_t maxLength = size - kLastLiterals - pos;
+                while (length < maxLength && in[match + length] == in[pos + length]) ++length;
+                // Take back bytes the previous literals already share
+                while (pos > anchor && match > 0 && in[pos - 1] == in[match - 1]) {
+                    --pos;
+                    --match;
+                    ++length;
+                }
+                out = putSequence(out, in + anchor, pos - anchor, pos - match, length);
+                pos += length;
+                anchor = pos;
+            }
+        }
+        out = putSequence(out, in + anchor, size - anchor, 0, 0);
+        return static_cast<size_t>(out - reinterpret_cast<uint8_t*>(dst));
+    }
+
+    bool decompressBlock(const char* src, size_t size, char* dst, size_t rawSize) {
+        const uint8_t* in = reinterpret_cast<const uint8_t*>(src);
+        const uint8_t* end = in + size;
+        uint8_t* out = reinterpret_cast<uint8_t*>(dst);
+        size_t written = 0;
+
+        while (in < end) {
+            uint8_t token = *in++;
+            size_t literalCount = token >> 4;
+            if (literalCount == 15 && !getLength(in, end, literalCount)) return false;
+            if (literalCount > static_cast<size_t>(end - in) || literalCount > rawSize - written) return false;
+            std::memcpy(out + written, in, literalCount);
+            in += literalCount;
+            written += literalCount;
+            if (in == end) break;  // the closing literals have no match
+
+            if (end - in < 2) return false;
+            size_t offset = in[0] | (static_cast<size_t>(in[1]) << 8);
+            in += 2;
+            if (offset == 0 || offset > written) return false;
+            size_t length = token & 15;
+            if (length == 15 && !getLength(in, end, length)) return false;
+            length += kMinMatch;
+            if (length > rawSize - written) return false;
+
+            uint8_t* to = out + written;
+            const uint8_t* from = to - offset;
+            if (offset >= length) {
+                std::memcpy(to, from, length);
+            }
+            else {
+                // Overlapping copy repeats the last offset bytes
+                for (size_t i = 0; i < length; ++i) to[i] = from[i];
+            }
+            written += length;
+        }
+        return written == rawSize;
+    }
+
+} // end namespace MyLibrary
@@ -0,0 +1,30 @@
+#pragma once
+#ifndef TASKCOMPRESS_H
+#define TASKCOMPRESS_H
+
+#include <cstddef>
+
+namespace MyLibrary
+{
+    /*
+     * Block compression for snapshots, in the LZ4 block format: a token
+     * byte holding literal and match lengths, the literals, then a 16-bit
+     * offset into the last 64KB of output. Greedy matching with one hash
+     * probe per position keeps it fast in both directions; decoding only
+     * copies bytes, so it runs well ahead of the disk.
+     */
+
+    // Largest possible output of compressBlock for size input bytes
+    size_t compressBound(size_t size);
+
+    // Compress src into dst (at least compressBound(size) bytes) and
+    // return the number of bytes written
+    size_t compressBlock(const char* src, size_t size, char* dst);
+
+    // Decode a block that must expand to exactly rawSize bytes. Corrupt
+    // input makes it return false; it never reads or writes out of bounds.
+    bool decompressBlock(const char* src, size_t size, char* dst, size_t rawSize);
+
+} // end namespace MyLibrary
+
+#endif // TASKCOMPRESS_H
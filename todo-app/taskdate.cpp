@@ -0,0 +1,116 @@
+#include "taskdate.h"
+
+#include <cstring>
+#include <limits>
+
+namespace MyLibrary
+{
+    namespace
+    {
+        const size_t kMaxCachedDays = 4096;
+        const time_t kSecondsPerDay = 24 * 60 * 60;
+        const time_t kBucketSeconds = 15 * 60;
+
+        bool sameDay(const std::tm& a, const std::tm& b) {
+            return a.tm_year == b.tm_year && a.tm_mon == b.tm_mon && a.tm_mday == b.tm_mday;
+        }
+
+        void putDigits(char* out, int value, int digits) {
+            for (int i = digits - 1; i >= 0; --i) {
+                out[i] = static_cast<char>('0' + value % 10);
+                value /= 10;
+            }
+        }
+
+        // "YYYY-MM-DD"; out needs 16 bytes
+        uint8_t formatLocalDate(const std::tm& local, char* out) {
+            int year = local.tm_year + 1900;
+            if (year < 1000 || year > 9999) {
+                // Leave unusual widths to strftime so the output is unchanged
+                return static_cast<uint8_t>(std::strftime(out, 16, "%Y-%m-%d", &local));
+            }
+            putDigits(out, year, 4);
+            out[4] = '-';
+            putDigits(out + 5, local.tm_mon + 1, 2);
+            out[7] = '-';
+            putDigits(out + 8, local.tm_mday, 2);
+            return 10;
+        }
+    }
+
+    bool toLocalTime(time_t t, std::tm& out) {
+#if defined(_WIN32)
+        return localtime_s(&out, &t) == 0;
+#else
+        return localtime_r(&t, &out) != nullptr;
+#endif
+    }
+
+    std::string_view DateFormatter::format(time_t t) {
+        // Floor division, so times before 1970 get their own buckets too
+        int64_t bucket = t >= 0 ? t / kBucketSeconds : -((-(t + 1)) / kBucketSeconds) - 1;
+        // Fibonacci hashing: days are 96 buckets apart, which a plain modulo
+        // would fold onto a few slots
+        Recent& slot = recent[(static_cast<uint64_t>(bucket) * 0x9E3779B97F4A7C15ull) >> (64 - kRecentBits)];
+        Days::iterator it;
+        if (slot.bucket == bucket && t >= slot.day->first && t < slot.day->second.end) {
+            it = slot.day;
+        }
+        else {
+            it = lookup(t);
+            if (it == days.end()) {
+                if (days.size() >= kMaxCachedDays) {
+                    days.clear();
+                    last = days.end();
+                    for (Recent& entry : recent) entry.bucket = INT64_MIN;
+                }
+                it = insert(t);
+            }
+            slot.bucket = bucket;
+            slot.day = it;
+        }
+        last = it;
+        return std::string_view(it->second.text, it->second.size);
+    }
+
+    DateFormatter::Days::iterator DateFormatter::lookup(time_t t) {
+        // Listings sorted or grouped by due date hit the same day repeatedly
+        if (last != days.end() && t >= last->first && t < last->second.end) return last;
+        Days::iterator it = days.upper_bound(t);
+        if (it == days.begin()) return days.end();
+        --it;
+        return t < it->second.end ? it : days.end();
+    }
+
+    DateFormatter::Days::iterator DateFormatter::insert(time_t t) {
+        Day day{};
+        time_t start = t;
+        day.end = t == std::numeric_limits<time_t>::max() ? t : t + 1;
+
+        std::tm local{};
+        if (!toLocalTime(t, local)) {
+            std::memcpy(day.text, "InvalidDate", 11);
+            day.size = 11;
+            return days.emplace(start, day).first;
+        }
+        day.size = formatLocalDate(local, day.text);
+
+        // Assume a plain 24-hour day around t, then make sure both ends
+        // really fall on the same local date (they don't across DST changes)
+        time_t into = local.tm_hour * 3600 + local.tm_min * 60 + local.tm_sec;
+        time_t dayStart = t - into;
+        time_t dayEnd = dayStart + kSecondsPerDay;
+        std::tm first{};
+        std::tm lastSecond{};
+        std::tm next{};
+        if (toLocalTime(dayStart, first) && sameDay(first, local)
+            && toLocalTime(dayEnd - 1, lastSecond) && sameDay(lastSecond, local)
+            && toLocalTime(dayEnd, next) && !sameDay(next, local)
+            && toLocalTime(dayStart - 1, next) && !sameDay(next, local)) {
+            start = dayStart;
+            day.end = dayEnd;
+        }
+        return days.emplace(start, day).first;
+    }
+
+} // end namespace MyLibrary
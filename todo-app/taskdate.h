@@ -0,0 +1,62 @@
+#pragma once
+#ifndef TASKDATE_H
+#define TASKDATE_H
+
+#include <map>
+#include <string_view>
+#include <cstdint>
+#include <ctime>
+
+namespace MyLibrary
+{
+    // Portable localtime: localtime_s on MSVC, localtime_r elsewhere.
+    // Returns false if t cannot be represented.
+    bool toLocalTime(time_t t, std::tm& out);
+
+    /**
+     * Formats due dates as local "YYYY-MM-DD" while calling into the C time
+     * library about once per distinct day instead of once per task.
+     *
+     * The first lookup for a day asks localtime where that local day starts
+     * and ends (in UTC), and remembers the range; later times in the range
+     * are answered from the cache without touching the time library. Days with a DST
+     * change are checked at both ends and fall back to exact-time entries
+     * if the range cannot be trusted.
+     */
+    class DateFormatter {
+    public:
+        DateFormatter() = default;
+        DateFormatter(const DateFormatter&) = delete;
+        DateFormatter& operator=(const DateFormatter&) = delete;
+
+        // The view stays valid until the next call
+        std::string_view format(time_t t);
+
+    private:
+        struct Day {
+            time_t end;     // exclusive
+            char text[16];  // "YYYY-MM-DD" or "InvalidDate"
+            uint8_t size;
+        };
+        using Days = std::map<time_t, Day>;  // keyed by the range start
+
+        Days::iterator lookup(time_t t);
+        Days::iterator insert(time_t t);
+
+        // Direct-mapped front cache over 15-minute buckets of t, checked
+        // before the ordered map
+        struct Recent {
+            int64_t bucket = INT64_MIN;
+            Days::iterator day;
+        };
+        static const unsigned kRecentBits = 10;
+        static const size_t kRecentSlots = size_t(1) << kRecentBits;
+
+        Days days;
+        Days::iterator last = days.end();
+        Recent recent[kRecentSlots];
+    };
+
+} // end namespace MyLibrary
+
+#endif // TASKDATE_H
@@ -0,0 +1,109 @@
+#include "taskindex.h"
+
+namespace MyLibrary
+{
+    namespace
+    {
+        const size_t kMinBuckets = 16;
+    }
+
+    TaskIndex::TaskIndex()
+        : buckets(kMinBuckets, Entry{ 0, npos }), count(0), mask(kMinBuckets - 1)
+    {}
+
+    size_t TaskIndex::home(int id) const {
+        // Fibonacci hashing spreads sequential IDs across the table
+        uint64_t h = static_cast<uint64_t>(static_cast<uint32_t>(id)) * 0x9E3779B97F4A7C15ull;
+        return static_cast<size_t>(h >> 32) & mask;
+    }
+
+    void TaskIndex::clear() {
+        buckets.assign(kMinBuckets, Entry{ 0, npos });
+        mask = kMinBuckets - 1;
+        count = 0;
+    }
+
+    void TaskIndex::reserve(size_t n) {
+        // Keep the load factor at or below 1/2
+        size_t wanted = kMinBuckets;
+        while (wanted < n * 2) wanted <<= 1;
+        if (wanted > buckets.size()) grow(wanted);
+    }
+
+    void TaskIndex::grow(size_t minBuckets) {
+        std::vector<Entry> old;
+        old.swap(buckets);
+        buckets.assign(minBuckets, Entry{ 0, npos });
+        mask = minBuckets - 1;
+        for (const Entry& e : old) {
+            if (e.slot == npos) continue;
+            size_t i = home(e.id);
+            while (buckets[i].slot != npos) i = (i + 1) & mask;
+            buckets[i] = e;
+        }
+    }
+
+    void TaskIndex::insert(int id, size_t slot) {
+        if ((count + 1) * 2 > buckets.size()) grow(buckets.size() * 2);
+
+        size_t i = home(id);
+        while (buckets[i].slot != npos) {
+            if (buckets[i].id == id) {
+                buckets[i].slot = slot;
+                return;
+            }
+            i = (i + 1) & mask;
+        }
+        buckets[i] = Entry{ id, slot };
+        count++;
+    }
+
+    bool TaskIndex::tryInsert(int id, size_t slot) {
+        if ((count + 1) * 2 > buckets.size()) grow(buckets.size() * 2);
+
+        size_t i = home(id);
+        while (buckets[i].slot != npos) {
+            if (buckets[i].id == id) return false;
+            i = (i + 1) & mask;
+        }
+        buckets[i] = Entry{ id, slot };
+        count++;
+        return true;
+    }
+
+    size_t TaskIndex::find(int id) const {
+        size_t i = home(id);
+        while (buckets[i].slot != npos) {
+            if (buckets[i].id == id) return buckets[i].slot;
+            i = (i + 1) & mask;
+        }
+        return npos;
+    }
+
+    bool TaskIndex::erase(int id) {
+        size_t i = home(id);
+        while (true) {
+            if (buckets[i].slot == npos) return false;
+            if (buckets[i].id == id) break;
+            i = (i + 1) & mask;
+        }
+
+        // Backward-shift the rest of the probe run into the hole
+        size_t j = i;
+        while (true) {
+            j = (j + 1) & mask;
+            if (buckets[j].slot == npos) break;
+            size_t k = home(buckets[j].id);
+            // Move entry j back only if its home is not in (i, j]
+            bool inRange = (i <= j) ? (i < k && k <= j) : (i < k || k <= j);
+            if (!inRange) {
+                buckets[i] = buckets[j];
+                i = j;
+            }
+        }
+        buckets[i].slot = npos;
+        count--;
+        return true;
+    }
+
+} // end namespace MyLibrary
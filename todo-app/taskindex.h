@@ -0,0 +1,52 @@
+#pragma once
+#ifndef TASKINDEX_H
+#define TASKINDEX_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace MyLibrary
+{
+    /**
+     * Open-addressing hash map from task ID to the task's slot in storage.
+     * Linear probing with backward-shift deletion: no tombstones, so lookups
+     * stay short no matter how many deletes have happened.
+     */
+    class TaskIndex {
+    public:
+        static constexpr size_t npos = static_cast<size_t>(-1);
+
+        TaskIndex();
+
+        void clear();
+        void reserve(size_t count);
+
+        // Insert a new mapping or overwrite the slot of an existing one.
+        void insert(int id, size_t slot);
+        // Insert only if the ID is absent; returns false if it was present.
+        bool tryInsert(int id, size_t slot);
+        // Returns false if the ID was not present.
+        bool erase(int id);
+        // Returns npos if the ID is not present.
+        size_t find(int id) const;
+
+        size_t size() const { return count; }
+
+    private:
+        struct Entry {
+            int id;
+            size_t slot;  // npos marks an empty bucket
+        };
+
+        std::vector<Entry> buckets;
+        size_t count;
+        size_t mask;
+
+        size_t home(int id) const;
+        void grow(size_t minBuckets);
+    };
+
+} // end namespace MyLibrary
+
+#endif // TASKINDEX_H
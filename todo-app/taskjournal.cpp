@@ -0,0 +1,275 @@
+#include "mylibrary.h"
+
+#include <filesystem>
+
+namespace MyLibrary
+{
+    namespace fs = std::filesystem;
+
+    /*--------------------- JOURNAL MODE ----------------------------------*/
+    // Compaction rotates tasks.journal to tasks.journal.old, keeps logging
+    // into a fresh tasks.journal, and writes the snapshot in the background.
+    // The .old file is only removed once the snapshot is safely on disk, so
+    // after a crash both journals are replayed; records whose seq is already
+    // covered by the snapshot are skipped.
+
+    bool TaskList::openJournal(const std::string& journalFile,
+        const std::string& snapshotFile,
+        uint64_t compactBytes)
+    {
+        closeJournal();
+        journalSnapshot = snapshotFile;
+        compactThreshold = compactBytes;
+
+        auto apply = [this](const JournalRecord& record) { applyJournalRecord(record); };
+        std::string oldFile = journalFile + ".old";
+        std::error_code ec;
+        bool interrupted = fs::exists(oldFile, ec);
+        if (interrupted && !Journal::replay(oldFile, apply)) return false;
+
+        uint64_t validSize = 0;
+        if (!Journal::replay(journalFile, apply, &validSize)) return false;
+        if (fs::exists(journalFile, ec) && fs::file_size(journalFile, ec) > validSize) {
+            // Drop the torn tail so new records are not appended after garbage
+            fs::resize_file(journalFile, validSize, ec);
+        }
+
+        if (interrupted) {
+            // Finish the compaction that was cut short. The tasks now cover
+            // both journals, so write them out and start over with neither;
+            // if that fails both journals stay and are replayed next time.
+            TODO_TIME_SCOPE(METRIC_SNAPSHOT_SAVE);
+            if (writeSnapshot(journalSnapshot, buildSnapshot(tasks.columns(), nextId, journalSeq, compressSnapshots))) {
+                fs::remove(oldFile, ec);
+                fs::remove(journalFile, ec);
+            }
+        }
+        return journal.open(journalFile);
+    }
+
+    bool TaskList::openJournalForAppend(const std::string& journalFile, const std::string& snapshotFile) {
+        closeJournal();
+        tasks.clear();
+        nextId = 1;
+        journalSeq = 0;
+        if (!readSnapshotHeader(snapshotFile, nextId, journalSeq)) return false;
+        journalSnapshot = snapshotFile;
+
+        // Only the IDs and sequence numbers matter here; nothing is applied
+        auto scan = [this](const JournalRecord& record) {
+            if (record.seq > journalSeq) journalSeq = record.seq;
+            if (record.op == JOURNAL_ADD && record.id >= nextId) nextId = record.id + 1;
+        };
+        std::string oldFile = journalFile + ".old";
+        std::error_code ec;
+        if (fs::exists(oldFile, ec) && !Journal::replay(oldFile, scan)) return false;
+
+        uint64_t validSize = 0;
+        if (!Journal::replay(journalFile, scan, &validSize)) return false;
+        if (fs::exists(journalFile, ec) && fs::file_size(journalFile, ec) > validSize) {
+            fs::resize_file(journalFile, validSize, ec);
+        }
+
+        if (!journal.open(journalFile)) return false;
+        appendOnly = true;
+        return true;
+    }
+
+    bool TaskList::isJournaling() const {
+        return journal.isOpen();
+    }
+
+    void TaskList::syncJournal() {
+        if (journal.isOpen()) journal.sync();
+    }
+
+    void TaskList::closeJournal() {
+        if (compaction.valid()) compaction.get();
+        if (!journal.isOpen() && lostJournal.empty()) return;
+
+        // Fold the journal into the snapshot so nothing but the snapshot
+        // is left to load. Append-only and concurrent mode have no tasks
+        // here to write; then, or if the write fails, the journal stays and
+        // is replayed next time.
+        std::string journalFile = lostJournal.empty() ? journal.path() : lostJournal;
+        bool folded = false;
+        if (!appendOnly && !concurrent) {
+            TODO_TIME_SCOPE(METRIC_SNAPSHOT_SAVE);
+            folded = writeSnapshot(journalSnapshot, buildSnapshot(tasks.columns(), nextId, journalSeq, compressSnapshots));
+        }
+        journal.close();
+        appendOnly = false;
+        lostJournal.clear();
+        if (folded) {
+            std::error_code ec;
+            fs::remove(journalFile + ".old", ec);
+            fs::remove(journalFile, ec);
+        }
+    }
+
+    void TaskList::logChange(JournalRecord& record) {
+        if (!journal.isOpen()) return;
+        record.seq = ++journalSeq;
+        journal.append(record);
+        if (journal.size() >= compactThreshold) compactJournal();
+    }
+
+    void TaskList::logChanges(std::vector<JournalRecord>& records) {
+        if (!journal.isOpen() || records.empty()) return;
+        for (JournalRecord& record : records) record.seq = ++journalSeq;
+        journal.appendAll(records);
+        if (journal.size() >= compactThreshold) compactJournal();
+    }
+
+    std::vector<MutationResult> TaskList::appendBatch(const std::vector<Mutation>& batch) {
+        std::vector<MutationResult> results(batch.size());
+        std::vector<JournalRecord> records;
+        records.reserve(batch.size());
+        for (size_t i = 0; i < batch.size(); ++i) {
+            const Mutation& m = batch[i];
+            MutationResult& result = results[i];
+            result.id = m.id;
+
+            JournalRecord record;
+            record.id = m.id;
+            if (m.op == MUTATION_ADD) {
+                result.id = 0;
+                if (!m.description || !m.priority || !isValidTask(*m.description, *m.priority)) {
+                    result.status = MUTATION_INVALID;
+                    continue;
+                }
+                result.id = nextId++;
+                record.op = JOURNAL_ADD;
+                record.id = result.id;
+                record.fields = FIELD_ALL;
+                record.description = *m.description;
+                record.priority = static_cast<uint8_t>(*m.priority);
+                record.completed = m.completed.value_or(false);
+                record.dueDate = m.dueDate.value_or(0);
+            }
+            else if (m.op == MUTATION_DELETE) {
+                record.op = JOURNAL_DELETE;
+                if (deleteMode == DELETE_SWAP) record.fields = FIELD_SWAPPED;
+            }
+            else {
+                Mutation change;
+                if (m.op == MUTATION_COMPLETE) change.completed = true;
+                else change = m;
+                // Without the task only the new values can be checked
+                if ((change.description && !isValidDescription(*change.description))
+                    || (change.priority && (*change.priority < HIGHEST || *change.priority > LOWEST))) {
+                    result.status = MUTATION_INVALID;
+                    continue;
+                }
+                record.op = JOURNAL_UPDATE;
+                if (change.description) {
+                    record.fields |= FIELD_DESCRIPTION;
+                    record.description = *change.description;
+                }
+                if (change.priority) {
+                    record.fields |= FIELD_PRIORITY;
+                    record.priority = static_cast<uint8_t>(*change.priority);
+                }
+                if (change.completed) {
+                    record.fields |= FIELD_COMPLETED;
+                    record.completed = *change.completed;
+                }
+                if (change.dueDate) {
+                    record.fields |= FIELD_DUE_DATE;
+                    record.dueDate = *change.dueDate;
+                }
+            }
+            records.push_back(std::move(record));
+        }
+        logChanges(records);
+        return results;
+    }
+
+    void TaskList::applyJournalRecord(const JournalRecord& record) {
+        if (record.seq <= journalSeq) return;  // already part of the snapshot
+        journalSeq = record.seq;
+
+        if ((record.fields & FIELD_PRIORITY)
+            && (record.priority < HIGHEST || record.priority > LOWEST)) {
+            std::cerr << "Skipping invalid journal record for task " << record.id << ".\n";
+            return;
+        }
+
+        size_t slot = tasks.find(record.id);
+        switch (record.op) {
+        case JOURNAL_ADD:
+            if (record.id >= nextId) nextId = record.id + 1;
+            if (slot != TaskIndex::npos) {
+                // The ID was handed out again without the journal; the task
+                // that has it now wins
+                std::cerr << "Skipping journal record: task " << record.id << " already exists.\n";
+                return;
+            }
+            insertTask(record.id, record.description, static_cast<Priority>(record.priority),
+                record.completed, static_cast<time_t>(record.dueDate));
+            return;
+        case JOURNAL_UPDATE:
+            if (slot == TaskIndex::npos) return;
+            break;
+        case JOURNAL_DELETE:
+            if (slot == TaskIndex::npos) return;
+            if (record.fields & FIELD_SWAPPED) tasks.eraseSwapLast(slot);
+            else tasks.erase(slot);
+            return;
+        }
+
+        if (record.fields & FIELD_DESCRIPTION) tasks.setDescription(slot, record.description);
+        if (record.fields & FIELD_PRIORITY) tasks.setPriority(slot, record.priority);
+        if (record.fields & FIELD_COMPLETED) tasks.setCompleted(slot, record.completed);
+        if (record.fields & FIELD_DUE_DATE) tasks.setDueDate(slot, static_cast<time_t>(record.dueDate));
+    }
+
+    void TaskList::compactJournal() {
+        // The store is empty in append-only mode; a snapshot of it would
+        // throw away everything
+        if (appendOnly) return;
+        if (compaction.valid()) {
+            // One compaction at a time; the next change will try again
+            if (compaction.wait_for(std::chrono::seconds(0)) != std::future_status::ready) return;
+            compaction.get();
+        }
+
+        std::string journalFile = journal.path();
+        std::string oldFile = journalFile + ".old";
+        std::error_code ec;
+        // The last snapshot write failed, so .old still holds records it
+        // was meant to cover. Rotating again would overwrite them; the
+        // journal keeps growing until openJournal finishes the job.
+        if (fs::exists(oldFile, ec)) return;
+        if (!journal.sync()) return;
+
+        journal.close();
+        if (!replaceFile(journalFile, oldFile)) {
+            std::cerr << "Error: Unable to rotate journal " << journalFile << ".\n";
+            journal.open(journalFile);
+            return;
+        }
+        if (!journal.open(journalFile)) {
+            // Put the rotated records back and keep logging into them
+            if (!replaceFile(oldFile, journalFile) || !journal.open(journalFile)) {
+                lostJournal = journalFile;
+                std::cerr << "Error: Journal " << journalFile
+                    << " is gone; changes are kept until the snapshot is written on exit.\n";
+            }
+            return;
+        }
+
+        // The snapshot is copy-on-write, so nothing is copied here; the first
+        // change made while it is being written copies the columns instead
+        compaction = std::async(std::launch::async,
+            [snapshotFile = journalSnapshot, oldFile, copy = tasks.columns(), next = nextId, seq = journalSeq,
+                compressed = compressSnapshots]() {
+                TODO_TIME_SCOPE(METRIC_SNAPSHOT_SAVE);
+                if (writeSnapshot(snapshotFile, buildSnapshot(copy, next, seq, compressed))) {
+                    std::error_code removeError;
+                    fs::remove(oldFile, removeError);
+                }
+            });
+    }
+
+} // end namespace MyLibrary
@@ -0,0 +1,393 @@
+#include "taskkernels.h"
+#include "threadpool.h"
+
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define TODO_KERNELS_X86 1
+#include <immintrin.h>
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define TODO_KERNELS_NEON 1
+#include <arm_neon.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// GCC and Clang only emit AVX2 instructions in functions marked for it;
+// MSVC accepts the intrinsics anywhere.
+#if defined(TODO_KERNELS_X86) && (defined(__GNUC__) || defined(__clang__))
+#define TODO_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TODO_TARGET_AVX2
+#endif
+
+namespace MyLibrary
+{
+    namespace
+    {
+        const size_t kBlock = 64;  // rows per bitset word
+
+        int popcount64(uint64_t word) {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+            return static_cast<int>(__popcnt64(word));
+#elif defined(_MSC_VER)
+            return static_cast<int>(__popcnt(static_cast<uint32_t>(word))
+                + __popcnt(static_cast<uint32_t>(word >> 32)));
+#else
+            return __builtin_popcountll(word);
+#endif
+        }
+
+        unsigned lowestSetBit(uint64_t word) {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+            unsigned long index;
+            _BitScanForward64(&index, word);
+            return static_cast<unsigned>(index);
+#elif defined(_MSC_VER)
+            unsigned long index;
+            if (_BitScanForward(&index, static_cast<unsigned long>(word))) return index;
+            _BitScanForward(&index, static_cast<unsigned long>(word >> 32));
+            return index + 32;
+#else
+            return static_cast<unsigned>(__builtin_ctzll(word));
+#endif
+        }
+
+        bool filtersPriority(const TaskFilter& filter) {
+            return filter.minPriority > 1 || filter.maxPriority < 5;
+        }
+
+        bool filtersDueDate(const TaskFilter& filter) {
+            return filter.dueFrom != std::numeric_limits<time_t>::min()
+                || filter.dueBefore != std::numeric_limits<time_t>::max();
+        }
+
+        uint64_t handleBlock(const DescriptionPool::Handle* handles, size_t rows, DescriptionPool::Handle value) {
+            uint64_t bits = 0;
+            for (size_t i = 0; i < rows; ++i) {
+                bits |= static_cast<uint64_t>(handles[i] == value) << i;
+            }
+            return bits;
+        }
+
+        // Description equality for one block, however the store keeps its text
+        uint64_t descriptionBlock(const TaskStore& store, size_t first, size_t rows,
+            std::string_view text, DescriptionPool::Handle handle)
+        {
+            if (store.interned()) {
+                return handleBlock(store.descriptionColumn().data() + first, rows, handle);
+            }
+            uint64_t bits = 0;
+            for (size_t i = 0; i < rows; ++i) {
+                bits |= static_cast<uint64_t>(store.description(first + i) == text) << i;
+            }
+            return bits;
+        }
+
+        uint64_t tailMask(size_t rows) {
+            return rows >= kBlock ? ~uint64_t(0) : (uint64_t(1) << rows) - 1;
+        }
+
+        /*----------------- scalar fallback -----------------*/
+
+        uint64_t priorityBlockScalar(const uint8_t* p, size_t rows, uint8_t lo, uint8_t hi) {
+            uint64_t bits = 0;
+            for (size_t i = 0; i < rows; ++i) {
+                bits |= static_cast<uint64_t>(p[i] >= lo && p[i] <= hi) << i;
+            }
+            return bits;
+        }
+
+        uint64_t dueBlockScalar(const time_t* d, size_t rows, time_t from, time_t before) {
+            uint64_t bits = 0;
+            for (size_t i = 0; i < rows; ++i) {
+                bits |= static_cast<uint64_t>(d[i] >= from && d[i] < before && d[i] != 0) << i;
+            }
+            return bits;
+        }
+
+        /*----------------- x86 AVX2 -----------------*/
+#ifdef TODO_KERNELS_X86
+        bool detectAvx2() {
+#if defined(__GNUC__) || defined(__clang__)
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2");
+#elif defined(_MSC_VER)
+            int info[4];
+            __cpuid(info, 0);
+            if (info[0] < 7) return false;
+            __cpuid(info, 1);
+            bool osxsave = (info[2] & (1 << 27)) != 0;
+            bool avx = (info[2] & (1 << 28)) != 0;
+            // The OS must also save the YMM registers on context switches
+            if (!osxsave || !avx || (_xgetbv(0) & 6) != 6) return false;
+            __cpuidex(info, 7, 0);
+            return (info[1] & (1 << 5)) != 0;
+#else
+            return false;
+#endif
+        }
+
+        bool hasAvx2() {
+            static const bool supported = detectAvx2();
+            return supported;
+        }
+
+        TODO_TARGET_AVX2 size_t countSetBitsAvx2(const uint64_t* words, size_t wordCount) {
+            // Nibble lookup popcount, summed per 64-bit lane with SAD
+            const __m256i lookup = _mm256_setr_epi8(
+                0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+            const __m256i lowNibble = _mm256_set1_epi8(0x0f);
+            __m256i total = _mm256_setzero_si256();
+            size_t i = 0;
+            for (; i + 4 <= wordCount; i += 4) {
+                __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words + i));
+                __m256i lo = _mm256_and_si256(v, lowNibble);
+                __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), lowNibble);
+                __m256i counts = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, lo),
+                    _mm256_shuffle_epi8(lookup, hi));
+                total = _mm256_add_epi64(total, _mm256_sad_epu8(counts, _mm256_setzero_si256()));
+            }
+            alignas(32) uint64_t lanes[4];
+            _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), total);
+            size_t result = static_cast<size_t>(lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+            for (; i < wordCount; ++i) result += static_cast<size_t>(popcount64(words[i]));
+            return result;
+        }
+
+        TODO_TARGET_AVX2 uint64_t priorityBlockAvx2(const uint8_t* p, uint8_t lo, uint8_t hi) {
+            const __m256i low = _mm256_set1_epi8(static_cast<char>(lo));
+            const __m256i high = _mm256_set1_epi8(static_cast<char>(hi));
+            uint64_t bits = 0;
+            for (int half = 0; half < 2; ++half) {
+                __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + half * 32));
+                // lo <= v <= hi as unsigned bytes
+                __m256i atLeast = _mm256_cmpeq_epi8(_mm256_max_epu8(v, low), v);
+                __m256i atMost = _mm256_cmpeq_epi8(_mm256_min_epu8(v, high), v);
+                uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_and_si256(atLeast, atMost)));
+                bits |= static_cast<uint64_t>(mask) << (half * 32);
+            }
+            return bits;
+        }
+
+        TODO_TARGET_AVX2 uint64_t dueBlockAvx2(const time_t* d, time_t from, time_t before) {
+            const __m256i lower = _mm256_set1_epi64x(static_cast<long long>(from));
+            const __m256i upper = _mm256_set1_epi64x(static_cast<long long>(before));
+            uint64_t bits = 0;
+            for (int i = 0; i < 16; ++i) {
+                __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(d + i * 4));
+                // from <= v  ==  !(from > v);  v < before  ==  before > v;
+                // a 0 (no due date) never matches
+                __m256i inRange = _mm256_andnot_si256(_mm256_cmpgt_epi64(lower, v),
+                    _mm256_cmpgt_epi64(upper, v));
+                inRange = _mm256_andnot_si256(_mm256_cmpeq_epi64(v, _mm256_setzero_si256()), inRange);
+                uint32_t mask = static_cast<uint32_t>(_mm256_movemask_pd(_mm256_castsi256_pd(inRange)));
+                bits |= static_cast<uint64_t>(mask) << (i * 4);
+            }
+            return bits;
+        }
+
+        TODO_TARGET_AVX2 void refineBlocksAvx2(uint64_t* bits, size_t blocks,
+            const uint8_t* priorities, const time_t* dueDates, const TaskFilter& filter,
+            bool byPriority, bool byDue)
+        {
+            for (size_t b = 0; b < blocks; ++b) {
+                uint64_t word = bits[b];
+                if (word && byPriority) {
+                    word &= priorityBlockAvx2(priorities + b * kBlock, filter.minPriority, filter.maxPriority);
+                }
+                if (word && byDue) {
+                    word &= dueBlockAvx2(dueDates + b * kBlock, filter.dueFrom, filter.dueBefore);
+                }
+                bits[b] = word;
+            }
+        }
+#endif // TODO_KERNELS_X86
+
+        /*----------------- ARM64 NEON -----------------*/
+#ifdef TODO_KERNELS_NEON
+        size_t countSetBitsNeon(const uint64_t* words, size_t wordCount) {
+            size_t result = 0;
+            size_t i = 0;
+            for (; i + 2 <= wordCount; i += 2) {
+                uint8x16_t v = vreinterpretq_u8_u64(vld1q_u64(words + i));
+                result += vaddvq_u8(vcntq_u8(v));  // at most 128, fits in a byte
+            }
+            for (; i < wordCount; ++i) result += static_cast<size_t>(popcount64(words[i]));
+            return result;
+        }
+
+        uint64_t priorityBlockNeon(const uint8_t* p, uint8_t lo, uint8_t hi) {
+            static const uint8_t weights[16] = { 1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128 };
+            const uint8x16_t weight = vld1q_u8(weights);
+            const uint8x16_t low = vdupq_n_u8(lo);
+            const uint8x16_t high = vdupq_n_u8(hi);
+            uint64_t bits = 0;
+            for (int q = 0; q < 4; ++q) {
+                uint8x16_t v = vld1q_u8(p + q * 16);
+                uint8x16_t inRange = vandq_u8(vcgeq_u8(v, low), vcleq_u8(v, high));
+                // Emulate movemask: weight each lane by its bit, then sum halves
+                uint8x16_t weighted = vandq_u8(inRange, weight);
+                uint64_t mask = vaddv_u8(vget_low_u8(weighted))
+                    | (static_cast<uint64_t>(vaddv_u8(vget_high_u8(weighted))) << 8);
+                bits |= mask << (q * 16);
+            }
+            return bits;
+        }
+
+        uint64_t dueBlockNeon(const time_t* d, time_t from, time_t before) {
+            const int64x2_t lower = vdupq_n_s64(static_cast<int64_t>(from));
+            const int64x2_t upper = vdupq_n_s64(static_cast<int64_t>(before));
+            uint64_t bits = 0;
+            for (int i = 0; i < 32; ++i) {
+                int64x2_t v = vld1q_s64(reinterpret_cast<const int64_t*>(d + i * 2));
+                uint64x2_t inRange = vandq_u64(vcgeq_s64(v, lower), vcltq_s64(v, upper));
+                inRange = vbicq_u64(inRange, vceqzq_s64(v));  // no due date
+                bits |= (vgetq_lane_u64(inRange, 0) & 1) << (i * 2);
+                bits |= (vgetq_lane_u64(inRange, 1) & 1) << (i * 2 + 1);
+            }
+            return bits;
+        }
+#endif // TODO_KERNELS_NEON
+
+        void refineBlocksPortable(uint64_t* bits, size_t blocks,
+            const uint8_t* priorities, const time_t* dueDates, const TaskFilter& filter,
+            bool byPriority, bool byDue)
+        {
+            for (size_t b = 0; b < blocks; ++b) {
+                uint64_t word = bits[b];
+#ifdef TODO_KERNELS_NEON
+                if (word && byPriority) {
+                    word &= priorityBlockNeon(priorities + b * kBlock, filter.minPriority, filter.maxPriority);
+                }
+                if (word && byDue) {
+                    word &= dueBlockNeon(dueDates + b * kBlock, filter.dueFrom, filter.dueBefore);
+                }
+#else
+                if (word && byPriority) {
+                    word &= priorityBlockScalar(priorities + b * kBlock, kBlock, filter.minPriority, filter.maxPriority);
+                }
+                if (word && byDue) {
+                    word &= dueBlockScalar(dueDates + b * kBlock, kBlock, filter.dueFrom, filter.dueBefore);
+                }
+#endif
+                bits[b] = word;
+            }
+        }
+    }
+
+    size_t countSetBits(const uint64_t* words, size_t wordCount) {
+#if defined(TODO_KERNELS_X86)
+        if (hasAvx2()) return countSetBitsAvx2(words, wordCount);
+#elif defined(TODO_KERNELS_NEON)
+        return countSetBitsNeon(words, wordCount);
+#endif
+        size_t result = 0;
+        for (size_t i = 0; i < wordCount; ++i) result += static_cast<size_t>(popcount64(words[i]));
+        return result;
+    }
+
+    void matchTasks(const TaskStore& store, const TaskFilter& filter, std::vector<uint64_t>& result) {
+        size_t n = store.size();
+        size_t words = (n + kBlock - 1) / kBlock;
+
+        // Status comes straight from the completed bitset
+        const std::vector<uint64_t>& completed = store.completedColumn();
+        if (!filter.completed) {
+            result.assign(words, ~uint64_t(0));
+        }
+        else if (*filter.completed) {
+            result.assign(completed.begin(), completed.end());
+        }
+        else {
+            result.resize(words);
+            for (size_t w = 0; w < words; ++w) result[w] = ~completed[w];
+        }
+        if (words > 0) result[words - 1] &= tailMask(n - (words - 1) * kBlock);
+
+        bool byPriority = filtersPriority(filter);
+        bool byDue = filtersDueDate(filter);
+        bool byDescription = filter.description.has_value();
+        if (!byPriority && !byDue && !byDescription) return;
+
+        std::string_view text;
+        DescriptionPool::Handle handle = DescriptionPool::npos;
+        if (byDescription) {
+            text = *filter.description;
+            handle = store.descriptionPool().find(text);
+            if (store.interned() && handle == DescriptionPool::npos) {
+                // No task has this text
+                std::fill(result.begin(), result.end(), 0);
+                return;
+            }
+        }
+
+        const uint8_t* priorities = store.priorityColumn().data();
+        const time_t* dueDates = store.dueDateColumn().data();
+        size_t fullBlocks = n / kBlock;
+        uint64_t* bits = result.data();
+#ifdef TODO_KERNELS_X86
+        bool avx2 = hasAvx2() && sizeof(time_t) == sizeof(int64_t);
+#endif
+        // Blocks are independent, so large stores are split across threads
+        size_t chunks = splitWork(fullBlocks, 256);
+        parallelFor(chunks, [&](size_t chunk) {
+            size_t first = chunkBegin(fullBlocks, chunks, chunk);
+            size_t count = chunkBegin(fullBlocks, chunks, chunk + 1) - first;
+            const uint8_t* p = priorities + first * kBlock;
+            const time_t* d = dueDates + first * kBlock;
+#ifdef TODO_KERNELS_X86
+            if (avx2) {
+                refineBlocksAvx2(bits + first, count, p, d, filter, byPriority, byDue);
+            }
+            else
+#endif
+            {
+                refineBlocksPortable(bits + first, count, p, d, filter, byPriority, byDue);
+            }
+            if (byDescription) {
+                for (size_t b = first; b < first + count; ++b) {
+                    if (bits[b]) bits[b] &= descriptionBlock(store, b * kBlock, kBlock, text, handle);
+                }
+            }
+        });
+
+        // Leftover rows that do not fill a whole block
+        size_t rows = n - fullBlocks * kBlock;
+        if (rows > 0) {
+            uint64_t& word = result[fullBlocks];
+            size_t first = fullBlocks * kBlock;
+            if (byPriority) word &= priorityBlockScalar(priorities + first, rows, filter.minPriority, filter.maxPriority);
+            if (byDue) word &= dueBlockScalar(dueDates + first, rows, filter.dueFrom, filter.dueBefore);
+            if (byDescription && word) word &= descriptionBlock(store, first, rows, text, handle);
+        }
+    }
+
+    size_t countMatching(const TaskStore& store, const TaskFilter& filter) {
+        if (!filtersPriority(filter) && !filtersDueDate(filter) && !filter.description) {
+            // Status only: no need to materialise a result bitset
+            if (!filter.completed) return store.size();
+            size_t done = store.countCompleted();
+            return *filter.completed ? done : store.size() - done;
+        }
+        std::vector<uint64_t> bits;
+        matchTasks(store, filter, bits);
+        return countSetBits(bits.data(), bits.size());
+    }
+
+    void collectSlots(const std::vector<uint64_t>& bits, std::vector<size_t>& slots) {
+        for (size_t w = 0; w < bits.size(); ++w) {
+            uint64_t word = bits[w];
+            while (word) {
+                slots.push_back(w * kBlock + lowestSetBit(word));
+                word &= word - 1;
+            }
+        }
+    }
+
+} // end namespace MyLibrary
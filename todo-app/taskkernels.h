@@ -0,0 +1,52 @@
+#pragma once
+#ifndef TASKKERNELS_H
+#define TASKKERNELS_H
+
+#include <vector>
+#include <optional>
+#include <string>
+#include <limits>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+
+#include "taskstore.h"
+
+namespace MyLibrary
+{
+    /**
+     * Conjunction of column predicates, e.g. "pending AND priority <= HIGH
+     * AND due < now". Unset parts match every task. A due date of 0 means
+     * "none", so undated tasks never match a due range.
+     */
+    struct TaskFilter {
+        std::optional<bool> completed;
+        // Exact match; a handle compare when the store interns descriptions
+        std::optional<std::string> description;
+        uint8_t minPriority = 1;   // inclusive, HIGHEST
+        uint8_t maxPriority = 5;   // inclusive, LOWEST
+        time_t dueFrom = std::numeric_limits<time_t>::min();    // inclusive
+        time_t dueBefore = std::numeric_limits<time_t>::max();  // exclusive
+    };
+
+    /*
+     * Bulk kernels over TaskStore columns. Each has an AVX2 path (picked at
+     * runtime on x86), a NEON path on ARM64 and a portable scalar fallback.
+     */
+
+    // Number of set bits in words[0 .. wordCount)
+    size_t countSetBits(const uint64_t* words, size_t wordCount);
+
+    // Evaluate filter over every slot; bit i of the result is set if slot i
+    // matches. Bits past store.size() are zero.
+    void matchTasks(const TaskStore& store, const TaskFilter& filter, std::vector<uint64_t>& result);
+
+    // Number of slots matching filter
+    size_t countMatching(const TaskStore& store, const TaskFilter& filter);
+
+    // Append the slot number of every set bit, in ascending order
+    void collectSlots(const std::vector<uint64_t>& bits, std::vector<size_t>& slots);
+
+} // end namespace MyLibrary
+
+#endif // TASKKERNELS_H
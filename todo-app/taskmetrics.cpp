@@ -0,0 +1,183 @@
+#include "taskmetrics.h"
+
+#include <atomic>
+#include <cstdio>
+
+namespace MyLibrary
+{
+    namespace
+    {
+        struct OperationCells {
+            std::atomic<uint64_t> count;
+            std::atomic<uint64_t> totalNanos;
+            std::atomic<uint64_t> maxNanos;
+            std::atomic<uint64_t> buckets[kLatencyBuckets];
+        };
+
+        // Static storage, so every cell starts at zero before main
+        OperationCells operationCells[METRIC_OPERATION_COUNT];
+        std::atomic<uint64_t> counterCells[METRIC_COUNTER_COUNT];
+
+        const char* const kOperationNames[METRIC_OPERATION_COUNT] = {
+            "load", "save", "snapshot_load", "snapshot_save", "add", "update",
+            "delete", "batch", "sort", "filter", "search", "display"
+        };
+        const char* const kCounterNames[METRIC_COUNTER_COUNT] = {
+            "bytes_read_total", "bytes_written_total", "file_syncs_total",
+            "arena_blocks_total", "arena_bytes_total", "pool_compactions_total",
+            "journal_records_total"
+        };
+
+        size_t bucketFor(uint64_t nanos) {
+            uint64_t micros = (nanos + 999) / 1000;
+            size_t bucket = 0;
+            while (bucket + 1 < kLatencyBuckets && (uint64_t(1) << bucket) < micros) ++bucket;
+            return bucket;
+        }
+
+        // Formatted locally so the caller's stream settings are left alone
+        void writeNumber(std::ostream& out, double value) {
+            char number[32];
+            int length = std::snprintf(number, sizeof(number), "%.9g", value);
+            out.write(number, length);
+        }
+    }
+
+    double LatencyHistogram::bucketBound(size_t bucket) {
+        return static_cast<double>(uint64_t(1) << bucket) * 1e-6;
+    }
+
+    double LatencyHistogram::quantile(double q) const {
+        if (count == 0) return 0.0;
+        uint64_t rank = static_cast<uint64_t>(q * static_cast<double>(count - 1)) + 1;
+        uint64_t seen = 0;
+        for (size_t i = 0; i < kLatencyBuckets; ++i) {
+            seen += buckets[i];
+            if (seen >= rank) return bucketBound(i);
+        }
+        return bucketBound(kLatencyBuckets - 1);
+    }
+
+    void recordLatency(MetricOperation op, uint64_t nanos) {
+        OperationCells& cells = operationCells[op];
+        cells.count.fetch_add(1, std::memory_order_relaxed);
+        cells.totalNanos.fetch_add(nanos, std::memory_order_relaxed);
+        cells.buckets[bucketFor(nanos)].fetch_add(1, std::memory_order_relaxed);
+        uint64_t max = cells.maxNanos.load(std::memory_order_relaxed);
+        while (nanos > max && !cells.maxNanos.compare_exchange_weak(max, nanos, std::memory_order_relaxed)) {
+        }
+    }
+
+    void addToCounter(MetricCounter counter, uint64_t amount) {
+        counterCells[counter].fetch_add(amount, std::memory_order_relaxed);
+    }
+
+    MetricsSnapshot readMetrics() {
+        MetricsSnapshot metrics;
+        for (size_t op = 0; op < METRIC_OPERATION_COUNT; ++op) {
+            const OperationCells& cells = operationCells[op];
+            LatencyHistogram& histogram = metrics.operations[op];
+            histogram.count = cells.count.load(std::memory_order_relaxed);
+            histogram.totalNanos = cells.totalNanos.load(std::memory_order_relaxed);
+            histogram.maxNanos = cells.maxNanos.load(std::memory_order_relaxed);
+            for (size_t i = 0; i < kLatencyBuckets; ++i) {
+                histogram.buckets[i] = cells.buckets[i].load(std::memory_order_relaxed);
+            }
+        }
+        for (size_t i = 0; i < METRIC_COUNTER_COUNT; ++i) {
+            metrics.counters[i] = counterCells[i].load(std::memory_order_relaxed);
+        }
+        return metrics;
+    }
+
+    void resetMetrics() {
+        for (OperationCells& cells : operationCells) {
+            cells.count.store(0, std::memory_order_relaxed);
+            cells.totalNanos.store(0, std::memory_order_relaxed);
+            cells.maxNanos.store(0, std::memory_order_relaxed);
+            for (std::atomic<uint64_t>& bucket : cells.buckets) bucket.store(0, std::memory_order_relaxed);
+        }
+        for (std::atomic<uint64_t>& counter : counterCells) counter.store(0, std::memory_order_relaxed);
+    }
+
+    const char* metricName(MetricOperation op) {
+        return kOperationNames[op];
+    }
+
+    const char* metricName(MetricCounter counter) {
+        return kCounterNames[counter];
+    }
+
+    void writePrometheusMetrics(std::ostream& out, const MetricsSnapshot& metrics) {
+        out << "# HELP todo_operation_seconds Time spent in task list operations.\n"
+            << "# TYPE todo_operation_seconds histogram\n";
+        for (size_t op = 0; op < METRIC_OPERATION_COUNT; ++op) {
+            const LatencyHistogram& histogram = metrics.operations[op];
+            const char* name = kOperationNames[op];
+            // Prometheus buckets are cumulative; the last one is +Inf
+            uint64_t cumulative = 0;
+            for (size_t i = 0; i + 1 < kLatencyBuckets; ++i) {
+                cumulative += histogram.buckets[i];
+                out << "todo_operation_seconds_bucket{op=\"" << name << "\",le=\"";
+                writeNumber(out, LatencyHistogram::bucketBound(i));
+                out << "\"} " << cumulative << '\n';
+            }
+            out << "todo_operation_seconds_bucket{op=\"" << name << "\",le=\"+Inf\"} " << histogram.count << '\n';
+            out << "todo_operation_seconds_sum{op=\"" << name << "\"} ";
+            writeNumber(out, histogram.totalNanos * 1e-9);
+            out << "\ntodo_operation_seconds_count{op=\"" << name << "\"} " << histogram.count << '\n';
+        }
+
+        out << "# HELP todo_operation_max_seconds Slowest single call of each operation.\n"
+            << "# TYPE todo_operation_max_seconds gauge\n";
+        for (size_t op = 0; op < METRIC_OPERATION_COUNT; ++op) {
+            out << "todo_operation_max_seconds{op=\"" << kOperationNames[op] << "\"} ";
+            writeNumber(out, metrics.operations[op].maxNanos * 1e-9);
+            out << '\n';
+        }
+
+        for (size_t i = 0; i < METRIC_COUNTER_COUNT; ++i) {
+            out << "# TYPE todo_" << kCounterNames[i] << " counter\n"
+                << "todo_" << kCounterNames[i] << ' ' << metrics.counters[i] << '\n';
+        }
+        for (const auto& gauge : metrics.gauges) {
+            out << "# TYPE todo_" << gauge.first << " gauge\n"
+                << "todo_" << gauge.first << ' ';
+            writeNumber(out, gauge.second);
+            out << '\n';
+        }
+    }
+
+    void writeJsonMetrics(std::ostream& out, const MetricsSnapshot& metrics) {
+        out << "{\n  \"enabled\": " << (metricsEnabled() ? "true" : "false") << ",\n  \"operations\": {\n";
+        for (size_t op = 0; op < METRIC_OPERATION_COUNT; ++op) {
+            const LatencyHistogram& histogram = metrics.operations[op];
+            out << "    \"" << kOperationNames[op] << "\": { \"count\": " << histogram.count << ", \"total_seconds\": ";
+            writeNumber(out, histogram.totalNanos * 1e-9);
+            out << ", \"max_seconds\": ";
+            writeNumber(out, histogram.maxNanos * 1e-9);
+            out << ", \"p50_seconds\": ";
+            writeNumber(out, histogram.quantile(0.5));
+            out << ", \"p99_seconds\": ";
+            writeNumber(out, histogram.quantile(0.99));
+            out << ", \"buckets\": [";
+            // Trailing empty buckets are left off
+            size_t used = kLatencyBuckets;
+            while (used > 0 && histogram.buckets[used - 1] == 0) --used;
+            for (size_t i = 0; i < used; ++i) out << (i ? ", " : "") << histogram.buckets[i];
+            out << "] }" << (op + 1 < METRIC_OPERATION_COUNT ? ",\n" : "\n");
+        }
+        out << "  },\n  \"counters\": {\n";
+        for (size_t i = 0; i < METRIC_COUNTER_COUNT; ++i) {
+            out << "    \"" << kCounterNames[i] << "\": " << metrics.counters[i]
+                << (i + 1 < METRIC_COUNTER_COUNT ? ",\n" : "\n");
+        }
+        out << "  },\n  \"gauges\": {";
+        for (size_t i = 0; i < metrics.gauges.size(); ++i) {
+            out << (i ? ",\n    \"" : "\n    \"") << metrics.gauges[i].first << "\": ";
+            writeNumber(out, metrics.gauges[i].second);
+        }
+        out << (metrics.gauges.empty() ? "}\n}\n" : "\n  }\n}\n");
+    }
+
+} // end namespace MyLibrary
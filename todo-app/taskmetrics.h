@@ -0,0 +1,127 @@
+#pragma once
+#ifndef TASKMETRICS_H
+#define TASKMETRICS_H
+
+#include <chrono>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+// Instrumentation is compiled in only when TODO_ENABLE_METRICS is defined
+// to 1 (e.g. /D TODO_ENABLE_METRICS=1). Otherwise the TODO_TIME_SCOPE and
+// TODO_COUNT macros expand to nothing and every reading stays zero; the
+// API below is always there, so callers need no #ifdefs.
+#ifndef TODO_ENABLE_METRICS
+#define TODO_ENABLE_METRICS 0
+#endif
+
+namespace MyLibrary
+{
+    /*
+     * Process-wide timers and counters for the hot paths. Every reading is
+     * a relaxed atomic, so background saves and compactions record without
+     * locks; a timed operation costs two clock reads and a few adds.
+     */
+
+    enum MetricOperation {
+        METRIC_LOAD,            // loadTasksFromFile
+        METRIC_SAVE,            // writing the text file, sync or background
+        METRIC_SNAPSHOT_LOAD,
+        METRIC_SNAPSHOT_SAVE,   // including journal compaction
+        METRIC_ADD,
+        METRIC_UPDATE,
+        METRIC_DELETE,
+        METRIC_BATCH,           // applyBatch
+        METRIC_SORT,
+        METRIC_FILTER,          // filters, counts and queries
+        METRIC_SEARCH,
+        METRIC_DISPLAY,         // listings
+        METRIC_OPERATION_COUNT
+    };
+
+    enum MetricCounter {
+        METRIC_BYTES_READ,      // files mapped for loading or replay
+        METRIC_BYTES_WRITTEN,   // task files, snapshots and the journal
+        METRIC_FILE_SYNCS,
+        METRIC_ARENA_BLOCKS,    // description arena allocations
+        METRIC_ARENA_BYTES,
+        METRIC_POOL_COMPACTIONS,
+        METRIC_JOURNAL_RECORDS,
+        METRIC_COUNTER_COUNT
+    };
+
+    // Bucket i counts operations that took at most 2^i microseconds; the
+    // last one also takes everything slower
+    const size_t kLatencyBuckets = 32;
+
+    struct LatencyHistogram {
+        uint64_t count = 0;
+        uint64_t totalNanos = 0;
+        uint64_t maxNanos = 0;
+        uint64_t buckets[kLatencyBuckets] = {};
+
+        // Upper bound in seconds of the bucket holding quantile q (0..1);
+        // 0 if nothing was recorded
+        double quantile(double q) const;
+        static double bucketBound(size_t bucket);
+    };
+
+    struct MetricsSnapshot {
+        LatencyHistogram operations[METRIC_OPERATION_COUNT];
+        uint64_t counters[METRIC_COUNTER_COUNT] = {};
+        // Point-in-time values added by the caller, e.g. TaskList::metrics
+        std::vector<std::pair<std::string, double>> gauges;
+    };
+
+    constexpr bool metricsEnabled() { return TODO_ENABLE_METRICS != 0; }
+
+    void recordLatency(MetricOperation op, uint64_t nanos);
+    void addToCounter(MetricCounter counter, uint64_t amount);
+    MetricsSnapshot readMetrics();
+    void resetMetrics();
+
+    const char* metricName(MetricOperation op);
+    const char* metricName(MetricCounter counter);
+
+    // Prometheus text exposition format: one histogram plus a max gauge
+    // per operation, then the counters and gauges, all prefixed "todo_"
+    void writePrometheusMetrics(std::ostream& out, const MetricsSnapshot& metrics);
+    void writeJsonMetrics(std::ostream& out, const MetricsSnapshot& metrics);
+
+    // Records the lifetime of the scope under op
+    class ScopedTimer {
+    public:
+        explicit ScopedTimer(MetricOperation op)
+            : op(op), start(std::chrono::steady_clock::now())
+        {}
+        ~ScopedTimer() {
+            auto elapsed = std::chrono::steady_clock::now() - start;
+            recordLatency(op, static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+        }
+
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    private:
+        MetricOperation op;
+        std::chrono::steady_clock::time_point start;
+    };
+
+} // end namespace MyLibrary
+
+#define TODO_METRICS_JOIN2(a, b) a##b
+#define TODO_METRICS_JOIN(a, b) TODO_METRICS_JOIN2(a, b)
+
+#if TODO_ENABLE_METRICS
+#define TODO_TIME_SCOPE(op) ::MyLibrary::ScopedTimer TODO_METRICS_JOIN(todoTimer, __LINE__)(op)
+#define TODO_COUNT(counter, amount) ::MyLibrary::addToCounter(counter, static_cast<uint64_t>(amount))
+#else
+#define TODO_TIME_SCOPE(op) ((void)0)
+#define TODO_COUNT(counter, amount) ((void)0)
+#endif
+
+#endif // TASKMETRICS_H
@@ -0,0 +1,68 @@
+#include "taskorder.h"
+#include "threadpool.h"
+
+#include <algorithm>
+#ifdef TODO_PARALLEL_STL
+#include <execution>
+#endif
+
+namespace MyLibrary
+{
+    void TaskOrderIndex::reset() {
+        ready = false;
+        priorityOrder.clear();
+        dueOrder.clear();
+    }
+
+    void TaskOrderIndex::build(const std::vector<int>& ids, const std::vector<uint8_t>& priorities,
+        const std::vector<time_t>& dueDates)
+    {
+        // Sort the keys once; a set built from sorted input takes linear time
+        size_t n = ids.size();
+        std::vector<PriorityKey> priorityKeys(n);
+        std::vector<DueKey> dueKeys(n);
+        for (size_t i = 0; i < n; ++i) {
+            priorityKeys[i] = PriorityKey(priorities[i], ids[i]);
+            dueKeys[i] = DueKey(dueDates[i], ids[i]);
+        }
+#ifdef TODO_PARALLEL_STL
+        if (parallelism() > 1) {
+            std::sort(std::execution::par_unseq, priorityKeys.begin(), priorityKeys.end());
+            std::sort(std::execution::par_unseq, dueKeys.begin(), dueKeys.end());
+        }
+        else
+#endif
+        {
+            std::sort(priorityKeys.begin(), priorityKeys.end());
+            std::sort(dueKeys.begin(), dueKeys.end());
+        }
+        priorityOrder = std::set<PriorityKey>(priorityKeys.begin(), priorityKeys.end());
+        dueOrder = std::set<DueKey>(dueKeys.begin(), dueKeys.end());
+        ready = true;
+    }
+
+    void TaskOrderIndex::add(int id, uint8_t priority, time_t dueDate) {
+        if (!ready) return;
+        priorityOrder.emplace(priority, id);
+        dueOrder.emplace(dueDate, id);
+    }
+
+    void TaskOrderIndex::remove(int id, uint8_t priority, time_t dueDate) {
+        if (!ready) return;
+        priorityOrder.erase(PriorityKey(priority, id));
+        dueOrder.erase(DueKey(dueDate, id));
+    }
+
+    void TaskOrderIndex::changePriority(int id, uint8_t from, uint8_t to) {
+        if (!ready || from == to) return;
+        priorityOrder.erase(PriorityKey(from, id));
+        priorityOrder.emplace(to, id);
+    }
+
+    void TaskOrderIndex::changeDueDate(int id, time_t from, time_t to) {
+        if (!ready || from == to) return;
+        dueOrder.erase(DueKey(from, id));
+        dueOrder.emplace(to, id);
+    }
+
+} // end namespace MyLibrary
@@ -0,0 +1,56 @@
+#pragma once
+#ifndef TASKORDER_H
+#define TASKORDER_H
+
+#include <set>
+#include <vector>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+
+namespace MyLibrary
+{
+    /**
+     * Secondary indexes over a TaskStore: task IDs ordered by (priority, id)
+     * and by (dueDate, id). Sorted views and due-date range queries walk
+     * these instead of re-sorting the columns.
+     *
+     * The index is built from the columns the first time it is needed and
+     * then kept current by every mutation. A copy starts out unbuilt, so a
+     * store copied for a background snapshot does not pay for it.
+     */
+    class TaskOrderIndex {
+    public:
+        using PriorityKey = std::pair<uint8_t, int>;
+        using DueKey = std::pair<time_t, int>;
+
+        TaskOrderIndex() = default;
+        TaskOrderIndex(const TaskOrderIndex&) {}
+        TaskOrderIndex(TaskOrderIndex&&) = default;
+        TaskOrderIndex& operator=(const TaskOrderIndex&) { reset(); return *this; }
+        TaskOrderIndex& operator=(TaskOrderIndex&&) = default;
+
+        bool built() const { return ready; }
+        void reset();
+        void build(const std::vector<int>& ids, const std::vector<uint8_t>& priorities,
+            const std::vector<time_t>& dueDates);
+
+        // No-ops until the index has been built
+        void add(int id, uint8_t priority, time_t dueDate);
+        void remove(int id, uint8_t priority, time_t dueDate);
+        void changePriority(int id, uint8_t from, uint8_t to);
+        void changeDueDate(int id, time_t from, time_t to);
+
+        const std::set<PriorityKey>& byPriority() const { return priorityOrder; }
+        const std::set<DueKey>& byDueDate() const { return dueOrder; }
+
+    private:
+        bool ready = false;
+        std::set<PriorityKey> priorityOrder;
+        std::set<DueKey> dueOrder;
+    };
+
+} // end namespace MyLibrary
+
+#endif // TASKORDER_H
@@ -0,0 +1,204 @@
+#include "taskquery.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace MyLibrary
+{
+    namespace
+    {
+        const int kMinId = std::numeric_limits<int>::min();
+
+        // Step through [lo, hi) forwards or backwards; false once exhausted
+        template <typename It, typename Key>
+        bool step(It& pos, It lo, It hi, bool ascending, Key& key) {
+            if (ascending) {
+                if (pos == hi) return false;
+                key = *pos++;
+            }
+            else {
+                if (pos == lo) return false;
+                key = *--pos;
+            }
+            return true;
+        }
+    }
+
+    /*--------------------- BUILDER ---------------------------------------*/
+
+    TaskQuery::TaskQuery(TaskStore& store)
+        : source(&store)
+    {
+    }
+
+    TaskQuery& TaskQuery::completed() & {
+        filter.completed = true;
+        return *this;
+    }
+
+    TaskQuery& TaskQuery::pending() & {
+        filter.completed = false;
+        return *this;
+    }
+
+    TaskQuery& TaskQuery::priorityAtMost(uint8_t priority) & {
+        filter.maxPriority = std::min(filter.maxPriority, priority);
+        return *this;
+    }
+
+    TaskQuery& TaskQuery::priorityAtLeast(uint8_t priority) & {
+        filter.minPriority = std::max(filter.minPriority, priority);
+        return *this;
+    }
+
+    TaskQuery& TaskQuery::dueFrom(time_t from) & {
+        filter.dueFrom = std::max(filter.dueFrom, from);
+        return *this;
+    }
+
+    TaskQuery& TaskQuery::dueBefore(time_t before) & {
+        filter.dueBefore = std::min(filter.dueBefore, before);
+        return *this;
+    }
+
+    TaskQuery& TaskQuery::descriptionIs(std::string_view text) & {
+        filter.description = std::string(text);
+        return *this;
+    }
+
+    TaskQuery& TaskQuery::descriptionContains(std::string_view text) & {
+        contains = std::string(text);
+        return *this;
+    }
+
+    TaskQuery& TaskQuery::orderBy(QueryOrder by, bool asc) & {
+        order = by;
+        ascending = asc;
+        return *this;
+    }
+
+    TaskQuery& TaskQuery::skip(size_t rows) & {
+        skipRows = rows;
+        return *this;
+    }
+
+    TaskQuery& TaskQuery::limit(size_t rows) & {
+        limitRows = rows;
+        return *this;
+    }
+
+    /*--------------------- EVALUATION ------------------------------------*/
+
+    bool TaskQuery::matches(size_t slot) const {
+        const TaskStore& store = *source;
+        if (filter.completed && store.completed(slot) != *filter.completed) return false;
+        uint8_t priority = store.priority(slot);
+        if (priority < filter.minPriority || priority > filter.maxPriority) return false;
+        time_t due = store.dueDate(slot);
+        if (due < filter.dueFrom || due >= filter.dueBefore) return false;
+        // No due date is outside every due range (see TaskFilter)
+        if (due == 0 && (filter.dueFrom != std::numeric_limits<time_t>::min()
+            || filter.dueBefore != std::numeric_limits<time_t>::max())) return false;
+        if (filter.description && store.description(slot) != *filter.description) return false;
+        if (contains && store.description(slot).find(*contains) == std::string_view::npos) return false;
+        return true;
+    }
+
+    std::vector<size_t> TaskQuery::slots() const {
+        std::vector<size_t> result;
+        if (order == ORDER_STORED && !contains) {
+            std::vector<uint64_t> bits;
+            matchTasks(*source, filter, bits);
+            collectSlots(bits, result);
+            if (!ascending) std::reverse(result.begin(), result.end());
+            size_t first = std::min(skipRows, result.size());
+            size_t last = limitRows == 0 ? result.size() : std::min(result.size(), first + limitRows);
+            result.erase(result.begin() + last, result.end());
+            result.erase(result.begin(), result.begin() + first);
+            return result;
+        }
+        for (size_t slot : *this) result.push_back(slot);
+        return result;
+    }
+
+    size_t TaskQuery::count() const {
+        if (order == ORDER_STORED && !contains && skipRows == 0 && limitRows == 0) {
+            return countMatching(*source, filter);
+        }
+        size_t n = 0;
+        for (iterator it = begin(); it != end(); ++it) ++n;
+        return n;
+    }
+
+    /*--------------------- ITERATOR --------------------------------------*/
+
+    TaskQuery::iterator::iterator(const TaskQuery& q)
+        : query(&q), done(false)
+    {
+        const TaskFilter& f = q.filter;
+        if (f.minPriority > f.maxPriority || f.dueFrom >= f.dueBefore) {
+            done = true;
+            return;
+        }
+        // Only the range of the index that can match is walked
+        if (q.order == ORDER_PRIORITY) {
+            const std::set<TaskOrderIndex::PriorityKey>& index = q.source->sortedIndex().byPriority();
+            priorityLo = index.lower_bound(TaskOrderIndex::PriorityKey(f.minPriority, kMinId));
+            priorityHi = index.lower_bound(TaskOrderIndex::PriorityKey(f.maxPriority + 1, kMinId));
+            priorityPos = q.ascending ? priorityLo : priorityHi;
+        }
+        else if (q.order == ORDER_DUE_DATE) {
+            const std::set<TaskOrderIndex::DueKey>& index = q.source->sortedIndex().byDueDate();
+            dueLo = index.lower_bound(TaskOrderIndex::DueKey(f.dueFrom, kMinId));
+            dueHi = f.dueBefore == std::numeric_limits<time_t>::max() ? index.end()
+                : index.lower_bound(TaskOrderIndex::DueKey(f.dueBefore, kMinId));
+            duePos = q.ascending ? dueLo : dueHi;
+        }
+        else {
+            nextSlot = q.ascending ? 0 : q.source->size();
+        }
+        advance();
+    }
+
+    bool TaskQuery::iterator::nextCandidate(size_t& candidate) {
+        const TaskQuery& q = *query;
+        if (q.order == ORDER_PRIORITY) {
+            TaskOrderIndex::PriorityKey key;
+            if (!step(priorityPos, priorityLo, priorityHi, q.ascending, key)) return false;
+            candidate = q.source->find(key.second);
+        }
+        else if (q.order == ORDER_DUE_DATE) {
+            TaskOrderIndex::DueKey key;
+            if (!step(duePos, dueLo, dueHi, q.ascending, key)) return false;
+            candidate = q.source->find(key.second);
+        }
+        else if (q.ascending) {
+            if (nextSlot == q.source->size()) return false;
+            candidate = nextSlot++;
+        }
+        else {
+            if (nextSlot == 0) return false;
+            candidate = --nextSlot;
+        }
+        return true;
+    }
+
+    void TaskQuery::iterator::advance() {
+        const TaskQuery& q = *query;
+        while (!done) {
+            if (q.limitRows != 0 && emitted == q.limitRows) break;
+            size_t candidate;
+            if (!nextCandidate(candidate)) break;
+            if (!q.matches(candidate)) continue;
+            if (skipped < q.skipRows) {
+                ++skipped;
+                continue;
+            }
+            slot = candidate;
+            ++emitted;
+            return;
+        }
+        done = true;
+    }
+
+} // end namespace MyLibrary
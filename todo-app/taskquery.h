@@ -0,0 +1,135 @@
+#pragma once
+#ifndef TASKQUERY_H
+#define TASKQUERY_H
+
+#include <vector>
+#include <set>
+#include <string>
+#include <string_view>
+#include <optional>
+#include <iterator>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+
+#include "taskstore.h"
+#include "taskorder.h"
+#include "taskkernels.h"
+
+namespace MyLibrary
+{
+    enum QueryOrder {
+        ORDER_STORED,    // display order of the store
+        ORDER_PRIORITY,  // priority, then ID (TaskOrderIndex)
+        ORDER_DUE_DATE   // due date, then ID (TaskOrderIndex)
+    };
+
+    /**
+     * Composable, lazily evaluated query over a TaskStore, e.g.
+     *
+     *     Task::query().pending().priorityAtMost(HIGH).dueBefore(t)
+     *         .orderBy(ORDER_DUE_DATE).limit(50)
+     *
+     * Nothing is evaluated until the query is iterated. Sorted queries walk
+     * the order index from the first key in range and stop after limit
+     * rows, so a top-N query only visits the rows it returns plus any that
+     * fail the other predicates. Iteration yields slot numbers, which stay
+     * valid until the store is next changed.
+     */
+    class TaskQuery {
+    public:
+        class iterator {
+        public:
+            using iterator_category = std::input_iterator_tag;
+            using value_type = size_t;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const size_t*;
+            using reference = const size_t&;
+
+            iterator() = default;
+            reference operator*() const { return slot; }
+            iterator& operator++() { advance(); return *this; }
+            bool operator==(const iterator& other) const {
+                return done == other.done && (done || slot == other.slot);
+            }
+            bool operator!=(const iterator& other) const { return !(*this == other); }
+
+        private:
+            friend class TaskQuery;
+            using PriorityIt = std::set<TaskOrderIndex::PriorityKey>::const_iterator;
+            using DueIt = std::set<TaskOrderIndex::DueKey>::const_iterator;
+
+            explicit iterator(const TaskQuery& query);
+            bool nextCandidate(size_t& candidate);
+            void advance();
+
+            const TaskQuery* query = nullptr;
+            bool done = true;
+            size_t slot = 0;
+            size_t skipped = 0;
+            size_t emitted = 0;
+            size_t nextSlot = 0;             // ORDER_STORED
+            PriorityIt priorityLo, priorityHi, priorityPos;
+            DueIt dueLo, dueHi, duePos;
+        };
+
+        explicit TaskQuery(TaskStore& store);
+
+        // ---------- Predicates (all must hold) ----------
+        // Each builder also has an rvalue form that returns the query by
+        // value, so a chain on a temporary (Task::query().pending()...)
+        // can be iterated directly in a range-for.
+        TaskQuery& completed() &;
+        TaskQuery completed() && { return std::move(completed()); }
+        TaskQuery& pending() &;
+        TaskQuery pending() && { return std::move(pending()); }
+        // Priority by value: priorityAtMost(HIGH) keeps HIGHEST and HIGH
+        TaskQuery& priorityAtMost(uint8_t priority) &;
+        TaskQuery priorityAtMost(uint8_t priority) && { return std::move(priorityAtMost(priority)); }
+        TaskQuery& priorityAtLeast(uint8_t priority) &;
+        TaskQuery priorityAtLeast(uint8_t priority) && { return std::move(priorityAtLeast(priority)); }
+        // Either due bound leaves out tasks without a due date
+        TaskQuery& dueFrom(time_t from) &;      // inclusive
+        TaskQuery dueFrom(time_t from) && { return std::move(dueFrom(from)); }
+        TaskQuery& dueBefore(time_t before) &;  // exclusive
+        TaskQuery dueBefore(time_t before) && { return std::move(dueBefore(before)); }
+        TaskQuery& descriptionIs(std::string_view text) &;
+        TaskQuery descriptionIs(std::string_view text) && { return std::move(descriptionIs(text)); }
+        TaskQuery& descriptionContains(std::string_view text) &;
+        TaskQuery descriptionContains(std::string_view text) && { return std::move(descriptionContains(text)); }
+
+        // ---------- Shape of the result ----------
+        TaskQuery& orderBy(QueryOrder order, bool ascending = true) &;
+        TaskQuery orderBy(QueryOrder order, bool ascending = true) && { return std::move(orderBy(order, ascending)); }
+        TaskQuery& skip(size_t rows) &;
+        TaskQuery skip(size_t rows) && { return std::move(skip(rows)); }
+        TaskQuery& limit(size_t rows) &;  // 0 = no limit
+        TaskQuery limit(size_t rows) && { return std::move(limit(rows)); }
+
+        iterator begin() const { return iterator(*this); }
+        iterator end() const { return iterator(); }
+
+        // All result slots at once. Unsorted queries without a substring
+        // test run the column kernels instead of visiting slots one by one.
+        std::vector<size_t> slots() const;
+        size_t count() const;
+
+        // Whether slot passes every predicate (ignores order, skip, limit)
+        bool matches(size_t slot) const;
+
+        const TaskStore& store() const { return *source; }
+
+    private:
+        TaskStore* source;
+        TaskFilter filter;
+        std::optional<std::string> contains;
+        QueryOrder order = ORDER_STORED;
+        bool ascending = true;
+        size_t skipRows = 0;
+        size_t limitRows = 0;
+    };
+
+} // end namespace MyLibrary
+
+#endif // TASKQUERY_H
@@ -0,0 +1,93 @@
+#include "taskschedule.h"
+
+namespace MyLibrary
+{
+    void TaskDueQueue::reset() {
+        ready = false;
+        heap.clear();
+        positions.clear();
+    }
+
+    void TaskDueQueue::build(const std::vector<int>& ids, const std::vector<uint64_t>& completedBits,
+        const std::vector<time_t>& dueDates)
+    {
+        heap.clear();
+        positions.clear();
+        for (size_t slot = 0; slot < ids.size(); ++slot) {
+            bool done = (completedBits[slot >> 6] >> (slot & 63)) & 1;
+            if (done || dueDates[slot] == 0) continue;
+            positions.insert(ids[slot], heap.size());
+            heap.push_back(Entry{ dueDates[slot], ids[slot] });
+        }
+        // Bottom-up heapify is O(n), cheaper than n pushes
+        for (size_t at = heap.size() / 2; at-- > 0;) siftDown(at);
+        ready = true;
+    }
+
+    void TaskDueQueue::schedule(int id, time_t due) {
+        if (!ready) return;
+        if (due == 0) {
+            cancel(id);
+            return;
+        }
+        size_t at = positions.find(id);
+        if (at == TaskIndex::npos) {
+            heap.push_back(Entry{ due, id });
+            positions.insert(id, heap.size() - 1);
+            siftUp(heap.size() - 1);
+            return;
+        }
+        time_t old = heap[at].due;
+        heap[at].due = due;
+        if (due < old) siftUp(at);
+        else siftDown(at);
+    }
+
+    void TaskDueQueue::cancel(int id) {
+        if (!ready) return;
+        size_t at = positions.find(id);
+        if (at != TaskIndex::npos) removeAt(at);
+    }
+
+    void TaskDueQueue::place(size_t at, const Entry& entry) {
+        heap[at] = entry;
+        positions.insert(entry.id, at);
+    }
+
+    void TaskDueQueue::siftUp(size_t at) {
+        Entry entry = heap[at];
+        while (at > 0) {
+            size_t parent = (at - 1) / 2;
+            if (!before(entry, heap[parent])) break;
+            place(at, heap[parent]);
+            at = parent;
+        }
+        place(at, entry);
+    }
+
+    void TaskDueQueue::siftDown(size_t at) {
+        Entry entry = heap[at];
+        size_t n = heap.size();
+        for (;;) {
+            size_t child = 2 * at + 1;
+            if (child >= n) break;
+            if (child + 1 < n && before(heap[child + 1], heap[child])) ++child;
+            if (!before(heap[child], entry)) break;
+            place(at, heap[child]);
+            at = child;
+        }
+        place(at, entry);
+    }
+
+    void TaskDueQueue::removeAt(size_t at) {
+        positions.erase(heap[at].id);
+        Entry last = heap.back();
+        heap.pop_back();
+        if (at == heap.size()) return;
+        // The moved entry may belong above or below the gap
+        place(at, last);
+        if (at > 0 && before(last, heap[(at - 1) / 2])) siftUp(at);
+        else siftDown(at);
+    }
+
+} // end namespace MyLibrary
@@ -0,0 +1,75 @@
+#pragma once
+#ifndef TASKSCHEDULE_H
+#define TASKSCHEDULE_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+
+#include "taskindex.h"
+
+namespace MyLibrary
+{
+    /**
+     * Pending tasks that have a due date, in a binary min-heap ordered by
+     * (dueDate, id), with each ID's heap position kept alongside so a
+     * change to one task is a sift of O(log n) instead of a re-sort.
+     * A due date of 0 means "none" and is never queued.
+     *
+     * Popping an entry takes the task out until schedule() is called for
+     * it again, which is how reminders fire once per due date.
+     *
+     * Like TaskTextIndex it is built on first use, then kept current by
+     * every mutation; a copy starts out unbuilt.
+     */
+    class TaskDueQueue {
+    public:
+        TaskDueQueue() = default;
+        TaskDueQueue(const TaskDueQueue&) {}
+        TaskDueQueue(TaskDueQueue&&) = default;
+        TaskDueQueue& operator=(const TaskDueQueue&) { reset(); return *this; }
+        TaskDueQueue& operator=(TaskDueQueue&&) = default;
+
+        bool built() const { return ready; }
+        void reset();
+        // Queue ids[i] for every pending i with a due date; completedBits
+        // holds one bit per slot as in TaskStore
+        void build(const std::vector<int>& ids, const std::vector<uint64_t>& completedBits,
+            const std::vector<time_t>& dueDates);
+
+        // No-ops until the queue has been built. schedule adds id or moves
+        // it to due; a due of 0 takes it out.
+        void schedule(int id, time_t due);
+        void cancel(int id);
+
+        bool contains(int id) const { return positions.find(id) != TaskIndex::npos; }
+        size_t size() const { return heap.size(); }
+        bool empty() const { return heap.empty(); }
+        // Earliest entry; only while !empty()
+        int topId() const { return heap.front().id; }
+        time_t topDue() const { return heap.front().due; }
+        void pop() { removeAt(0); }
+
+    private:
+        struct Entry {
+            time_t due;
+            int id;
+        };
+
+        static bool before(const Entry& a, const Entry& b) {
+            return a.due < b.due || (a.due == b.due && a.id < b.id);
+        }
+        void place(size_t at, const Entry& entry);
+        void siftUp(size_t at);
+        void siftDown(size_t at);
+        void removeAt(size_t at);
+
+        bool ready = false;
+        std::vector<Entry> heap;
+        TaskIndex positions;  // ID -> index in heap
+    };
+
+} // end namespace MyLibrary
+
+#endif // TASKSCHEDULE_H
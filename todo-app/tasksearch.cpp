@@ -0,0 +1,293 @@
+#include "tasksearch.h"
+
+#include <algorithm>
+#include <cctype>
+#include <iterator>
+#include <unordered_map>
+
+namespace MyLibrary
+{
+    namespace
+    {
+        // Side lists are merged into the packed bytes once they hold an
+        // eighth of the list, within these bounds
+        const size_t kMinPending = 32;
+        const size_t kMaxPending = 4096;
+        const size_t kSkipInterval = 128;
+
+        bool isWordByte(unsigned char c) {
+            // Bytes of multi-byte UTF-8 characters count as letters
+            return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c >= 0x80;
+        }
+
+        char lower(unsigned char c) {
+            return static_cast<char>(c >= 'A' && c <= 'Z' ? c - 'A' + 'a' : c);
+        }
+
+        void putVarint(std::vector<uint8_t>& out, uint32_t value) {
+            while (value >= 0x80) {
+                out.push_back(static_cast<uint8_t>(value | 0x80));
+                value >>= 7;
+            }
+            out.push_back(static_cast<uint8_t>(value));
+        }
+
+        // Append the lower-cased words of text, in order
+        void splitWords(std::string_view text, std::vector<std::string>& words) {
+            size_t i = 0;
+            while (i < text.size()) {
+                while (i < text.size() && !isWordByte(static_cast<unsigned char>(text[i]))) ++i;
+                size_t start = i;
+                while (i < text.size() && isWordByte(static_cast<unsigned char>(text[i]))) ++i;
+                if (i == start) break;
+                std::string word(text.substr(start, i - start));
+                for (char& c : word) c = lower(static_cast<unsigned char>(c));
+                words.push_back(std::move(word));
+            }
+        }
+
+        bool hasValue(const std::vector<int>& sorted, int value) {
+            return std::binary_search(sorted.begin(), sorted.end(), value);
+        }
+
+        void insertValue(std::vector<int>& sorted, int value) {
+            sorted.insert(std::lower_bound(sorted.begin(), sorted.end(), value), value);
+        }
+
+        void eraseValue(std::vector<int>& sorted, int value) {
+            sorted.erase(std::lower_bound(sorted.begin(), sorted.end(), value));
+        }
+
+        // Read one varint at p and advance past it
+        uint32_t getVarint(const uint8_t*& p) {
+            uint32_t value = *p & 0x7f;
+            unsigned shift = 7;
+            while (*p++ & 0x80) {
+                value |= static_cast<uint32_t>(*p & 0x7f) << shift;
+                shift += 7;
+            }
+            return value;
+        }
+    }
+
+    void TaskTextIndex::tokenize(std::string_view text, std::vector<std::string>& words) {
+        words.clear();
+        splitWords(text, words);
+        std::sort(words.begin(), words.end());
+        words.erase(std::unique(words.begin(), words.end()), words.end());
+    }
+
+    void TaskTextIndex::reset() {
+        ready = false;
+        terms.clear();
+    }
+
+    void TaskTextIndex::build(const std::vector<int>& ids, const std::vector<std::string_view>& texts) {
+        std::unordered_map<std::string, std::vector<int>> lists;
+        for (size_t i = 0; i < ids.size(); ++i) {
+            tokenize(texts[i], scratch);
+            for (std::string& word : scratch) lists[std::move(word)].push_back(ids[i]);
+        }
+
+        terms.clear();
+        for (auto& entry : lists) {
+            std::vector<int>& list = entry.second;
+            std::sort(list.begin(), list.end());
+            Posting posting;
+            for (int id : list) append(posting, id);
+            posting.packed.shrink_to_fit();
+            posting.skips.shrink_to_fit();
+            terms.emplace(entry.first, std::move(posting));
+        }
+        ready = true;
+    }
+
+    void TaskTextIndex::add(int id, std::string_view text) {
+        if (!ready) return;
+        tokenize(text, scratch);
+        for (const std::string& word : scratch) {
+            auto it = terms.find(word);
+            if (it == terms.end()) it = terms.emplace(word, Posting()).first;
+            Posting& posting = it->second;
+            if (hasValue(posting.removed, id)) {
+                // Still in the packed bytes; just take back the removal
+                eraseValue(posting.removed, id);
+            }
+            else if (posting.packedCount == 0 || id > posting.last) {
+                append(posting, id);
+            }
+            else {
+                insertValue(posting.added, id);
+                repackIfNeeded(posting);
+            }
+        }
+    }
+
+    void TaskTextIndex::remove(int id, std::string_view text) {
+        if (!ready) return;
+        tokenize(text, scratch);
+        for (const std::string& word : scratch) {
+            auto it = terms.find(word);
+            if (it == terms.end()) continue;
+            Posting& posting = it->second;
+            if (hasValue(posting.added, id)) eraseValue(posting.added, id);
+            else insertValue(posting.removed, id);
+            if (posting.size() == 0) terms.erase(it);
+            else repackIfNeeded(posting);
+        }
+    }
+
+    void TaskTextIndex::append(Posting& posting, int id) {
+        uint32_t base = posting.packedCount == 0 ? 0 : static_cast<uint32_t>(posting.last);
+        if (posting.packedCount % kSkipInterval == 0) {
+            posting.skips.push_back(Skip{ id, static_cast<uint32_t>(posting.packed.size()), base });
+        }
+        putVarint(posting.packed, static_cast<uint32_t>(id) - base);
+        posting.last = id;
+        ++posting.packedCount;
+    }
+
+    void TaskTextIndex::decode(const Posting& posting, std::vector<int>& ids) {
+        ids.clear();
+        ids.reserve(posting.size());
+        uint32_t value = 0;
+        const uint8_t* p = posting.packed.data();
+        const uint8_t* end = p + posting.packed.size();
+        while (p != end) {
+            value += getVarint(p);
+            ids.push_back(static_cast<int>(value));
+        }
+        if (posting.added.empty() && posting.removed.empty()) return;
+
+        if (!posting.removed.empty()) {
+            std::vector<int> kept;
+            kept.reserve(ids.size());
+            std::set_difference(ids.begin(), ids.end(), posting.removed.begin(), posting.removed.end(),
+                std::back_inserter(kept));
+            ids.swap(kept);
+        }
+        if (!posting.added.empty()) {
+            size_t middle = ids.size();
+            ids.insert(ids.end(), posting.added.begin(), posting.added.end());
+            std::inplace_merge(ids.begin(), ids.begin() + middle, ids.end());
+        }
+    }
+
+    bool TaskTextIndex::contains(const Posting& posting, int id) {
+        if (hasValue(posting.added, id)) return true;
+        if (hasValue(posting.removed, id)) return false;
+        auto block = std::upper_bound(posting.skips.begin(), posting.skips.end(), id,
+            [](int value, const Skip& skip) { return value < skip.first; });
+        if (block == posting.skips.begin()) return false;
+        --block;
+        const uint8_t* p = posting.packed.data() + block->offset;
+        const uint8_t* end = block + 1 == posting.skips.end()
+            ? posting.packed.data() + posting.packed.size()
+            : posting.packed.data() + (block + 1)->offset;
+        uint32_t value = block->base;
+        while (p != end) {
+            value += getVarint(p);
+            int current = static_cast<int>(value);
+            if (current >= id) return current == id;
+        }
+        return false;
+    }
+
+    void TaskTextIndex::repack(Posting& posting) {
+        std::vector<int> ids;
+        decode(posting, ids);
+        posting = Posting();
+        for (int id : ids) append(posting, id);
+    }
+
+    void TaskTextIndex::repackIfNeeded(Posting& posting) {
+        size_t limit = std::min(kMaxPending, std::max(kMinPending, posting.packedCount / 8));
+        if (posting.added.size() + posting.removed.size() > limit) repack(posting);
+    }
+
+    void TaskTextIndex::lookup(const std::string& word, bool prefix, std::vector<int>& ids) const {
+        ids.clear();
+        if (!prefix) {
+            auto it = terms.find(word);
+            if (it != terms.end()) decode(it->second, ids);
+            return;
+        }
+        // Union of every term in [word, word + 0xff...)
+        std::vector<int> part;
+        for (auto it = terms.lower_bound(word);
+            it != terms.end() && it->first.compare(0, word.size(), word) == 0; ++it) {
+            decode(it->second, part);
+            ids.insert(ids.end(), part.begin(), part.end());
+        }
+        std::sort(ids.begin(), ids.end());
+        ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+    }
+
+    void TaskTextIndex::search(std::string_view query, std::vector<int>& result) const {
+        result.clear();
+        // Split on whitespace first so a trailing '*' stays with its word
+        std::vector<std::pair<std::string, bool>> words;
+        std::vector<std::string> parts;
+        size_t i = 0;
+        while (i < query.size()) {
+            while (i < query.size() && std::isspace(static_cast<unsigned char>(query[i]))) ++i;
+            size_t start = i;
+            while (i < query.size() && !std::isspace(static_cast<unsigned char>(query[i]))) ++i;
+            std::string_view word = query.substr(start, i - start);
+            bool prefix = !word.empty() && word.back() == '*';
+            // "foo-bar*" is foo AND bar*
+            parts.clear();
+            splitWords(word, parts);
+            for (size_t p = 0; p < parts.size(); ++p) {
+                words.emplace_back(std::move(parts[p]), prefix && p + 1 == parts.size());
+            }
+        }
+        if (words.empty()) return;
+
+        // Start from the rarest word. Later words much more common than the
+        // running result are probed ID by ID through the skip entries
+        // instead of being decoded in full.
+        std::vector<size_t> sizes(words.size());
+        std::vector<size_t> order(words.size());
+        for (size_t w = 0; w < words.size(); ++w) {
+            sizes[w] = estimate(words[w].first, words[w].second);
+            if (sizes[w] == 0) return;  // AND with nothing
+            order[w] = w;
+        }
+        std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return sizes[a] < sizes[b]; });
+
+        lookup(words[order[0]].first, words[order[0]].second, result);
+        std::vector<int> list;
+        std::vector<int> next;
+        for (size_t k = 1; k < order.size() && !result.empty(); ++k) {
+            const std::pair<std::string, bool>& word = words[order[k]];
+            next.clear();
+            if (!word.second && sizes[order[k]] > result.size() * 8) {
+                const Posting& posting = terms.find(word.first)->second;
+                for (int id : result) {
+                    if (contains(posting, id)) next.push_back(id);
+                }
+            }
+            else {
+                lookup(word.first, word.second, list);
+                std::set_intersection(result.begin(), result.end(), list.begin(), list.end(),
+                    std::back_inserter(next));
+            }
+            result.swap(next);
+        }
+    }
+
+    size_t TaskTextIndex::estimate(const std::string& word, bool prefix) const {
+        if (!prefix) {
+            auto it = terms.find(word);
+            return it == terms.end() ? 0 : it->second.size();
+        }
+        size_t total = 0;
+        for (auto it = terms.lower_bound(word);
+            it != terms.end() && it->first.compare(0, word.size(), word) == 0; ++it) {
+            total += it->second.size();
+        }
+        return total;
+    }
+
+} // end namespace MyLibrary
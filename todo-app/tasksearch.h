@@ -0,0 +1,92 @@
+#pragma once
+#ifndef TASKSEARCH_H
+#define TASKSEARCH_H
+
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace MyLibrary
+{
+    /**
+     * Inverted index over task descriptions: lower-cased word -> IDs of the
+     * tasks whose description contains it.
+     *
+     * Each posting list keeps its IDs sorted and delta/varint packed, with
+     * a skip entry every 128 IDs. IDs are handed out in increasing order,
+     * so new tasks normally append to the packed bytes; anything else
+     * (edits, deletes, old IDs) goes to small sorted side lists that are
+     * merged back in once they grow.
+     *
+     * Like TaskOrderIndex it is built on first use, then kept current by
+     * every mutation; a copy starts out unbuilt.
+     */
+    class TaskTextIndex {
+    public:
+        TaskTextIndex() = default;
+        TaskTextIndex(const TaskTextIndex&) {}
+        TaskTextIndex(TaskTextIndex&&) = default;
+        TaskTextIndex& operator=(const TaskTextIndex&) { reset(); return *this; }
+        TaskTextIndex& operator=(TaskTextIndex&&) = default;
+
+        bool built() const { return ready; }
+        void reset();
+        // Index text for the task with ids[i], for every i
+        void build(const std::vector<int>& ids, const std::vector<std::string_view>& texts);
+
+        // No-ops until the index has been built
+        void add(int id, std::string_view text);
+        void remove(int id, std::string_view text);
+
+        /**
+         * IDs (ascending) of tasks containing every word of query. A word
+         * ending in '*' matches any word starting with it, e.g. "rep* q3".
+         * Matching ignores ASCII case and punctuation.
+         */
+        void search(std::string_view query, std::vector<int>& result) const;
+
+        size_t termCount() const { return terms.size(); }
+
+        // Lower-cased words of text, sorted and without duplicates
+        static void tokenize(std::string_view text, std::vector<std::string>& words);
+
+    private:
+        // Where every kSkipInterval-th packed entry starts, so membership
+        // tests decode one block instead of the whole list
+        struct Skip {
+            int first;        // ID of the block's first entry
+            uint32_t offset;  // into packed
+            uint32_t base;    // value the block's first delta applies to
+        };
+
+        struct Posting {
+            std::vector<uint8_t> packed;  // varint deltas of sorted IDs
+            std::vector<Skip> skips;
+            size_t packedCount = 0;
+            int last = 0;                 // largest ID in packed
+            std::vector<int> added;       // sorted; not in packed
+            std::vector<int> removed;     // sorted; in packed, but gone
+            size_t size() const { return packedCount + added.size() - removed.size(); }
+        };
+
+        static void append(Posting& posting, int id);
+        static void decode(const Posting& posting, std::vector<int>& ids);
+        static bool contains(const Posting& posting, int id);
+        static void repack(Posting& posting);
+        static void repackIfNeeded(Posting& posting);
+        // IDs for one query word; prefix matches every term starting with it
+        void lookup(const std::string& word, bool prefix, std::vector<int>& ids) const;
+        // Number of IDs lookup would return, without decoding anything
+        size_t estimate(const std::string& word, bool prefix) const;
+
+        bool ready = false;
+        std::map<std::string, Posting, std::less<>> terms;
+        std::vector<std::string> scratch;
+    };
+
+} // end namespace MyLibrary
+
+#endif // TASKSEARCH_H
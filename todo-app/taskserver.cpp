@@ -0,0 +1,342 @@
+#include "taskserver.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <vector>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#ifdef _MSC_VER
+#pragma comment(lib, "Ws2_32.lib")
+#endif
+#else
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+namespace MyLibrary
+{
+    namespace
+    {
+        const size_t kReadSize = 64 * 1024;
+        // A client that sends this much without a newline is dropped
+        const size_t kMaxLine = 1 << 20;
+        // How often run() looks at the stop flag
+        const int kPollMillis = 200;
+
+#ifdef _WIN32
+        const int kSendFlags = 0;
+
+        void closeSocket(uintptr_t socket) {
+            closesocket(static_cast<SOCKET>(socket));
+        }
+
+        bool wouldBlock() {
+            return WSAGetLastError() == WSAEWOULDBLOCK;
+        }
+
+        bool setNonBlocking(uintptr_t socket) {
+            u_long on = 1;
+            return ioctlsocket(static_cast<SOCKET>(socket), FIONBIO, &on) == 0;
+        }
+#else
+#ifdef MSG_NOSIGNAL
+        const int kSendFlags = MSG_NOSIGNAL;  // a closed peer is an error, not SIGPIPE
+#else
+        const int kSendFlags = 0;
+#endif
+
+        void closeSocket(int socket) {
+            ::close(socket);
+        }
+
+        bool wouldBlock() {
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+
+        bool setNonBlocking(int socket) {
+            int flags = fcntl(socket, F_GETFL, 0);
+            return flags >= 0 && fcntl(socket, F_SETFL, flags | O_NONBLOCK) == 0;
+        }
+#endif
+    }
+
+    struct TaskServer::Connection {
+        Connection(SocketHandle socket, TaskList& list, std::ostream& replies)
+            : socket(socket), runner(list, replies)
+        {
+        }
+
+        SocketHandle socket;
+        TaskCommandRunner runner;
+        std::string input;      // start of a line still being received
+        std::string output;     // replies not yet sent
+        size_t sent = 0;        // bytes of output already sent
+        bool closing = false;   // close once output is sent
+        unsigned watched = 0;   // events registered with epoll
+    };
+
+    TaskServer::TaskServer(TaskList& list)
+        : list(list)
+    {
+#ifdef _WIN32
+        WSADATA data;
+        WSAStartup(MAKEWORD(2, 2), &data);
+#endif
+        list.setOutput(replies);
+    }
+
+    TaskServer::~TaskServer() {
+        while (!connections.empty()) close(connections.begin()->first);
+        if (listener != static_cast<SocketHandle>(-1)) closeSocket(listener);
+#ifdef _WIN32
+        WSACleanup();
+#else
+        if (epollFd >= 0) ::close(epollFd);
+#endif
+        list.setOutput(std::cout);
+    }
+
+    bool TaskServer::listen(const std::string& host, uint16_t port) {
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(port);
+        if (inet_pton(AF_INET, host.c_str(), &address.sin_addr) != 1) {
+            std::cerr << "Error: Invalid listen address " << host << ".\n";
+            return false;
+        }
+
+        SocketHandle socket = static_cast<SocketHandle>(::socket(AF_INET, SOCK_STREAM, 0));
+        if (socket == static_cast<SocketHandle>(-1)) {
+            std::cerr << "Error: Unable to create a socket.\n";
+            return false;
+        }
+        int on = 1;
+        setsockopt(socket, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&on), sizeof(on));
+        if (bind(socket, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0
+            || ::listen(socket, SOMAXCONN) != 0 || !setNonBlocking(socket)) {
+            std::cerr << "Error: Unable to listen on " << host << ":" << port << ".\n";
+            closeSocket(socket);
+            return false;
+        }
+
+        socklen_t length = sizeof(address);
+        getsockname(socket, reinterpret_cast<sockaddr*>(&address), &length);
+        boundPort = ntohs(address.sin_port);
+
+#ifndef _WIN32
+        epollFd = epoll_create1(0);
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.fd = socket;
+        if (epollFd < 0 || epoll_ctl(epollFd, EPOLL_CTL_ADD, socket, &event) != 0) {
+            std::cerr << "Error: Unable to start the event loop.\n";
+            closeSocket(socket);
+            return false;
+        }
+#endif
+        listener = socket;
+        return true;
+    }
+
+    bool TaskServer::run() {
+        if (listener == static_cast<SocketHandle>(-1)) return false;
+#ifdef _WIN32
+        std::vector<WSAPOLLFD> sockets;
+        while (!stopping) {
+            sockets.clear();
+            sockets.push_back(WSAPOLLFD{ static_cast<SOCKET>(listener), POLLRDNORM, 0 });
+            for (const auto& entry : connections) {
+                const Connection& connection = *entry.second;
+                SHORT events = connection.closing ? 0 : POLLRDNORM;
+                if (!connection.output.empty()) events |= POLLWRNORM;
+                sockets.push_back(WSAPOLLFD{ static_cast<SOCKET>(entry.first), events, 0 });
+            }
+            int ready = WSAPoll(sockets.data(), static_cast<ULONG>(sockets.size()), kPollMillis);
+            if (ready < 0) {
+                std::cerr << "Error: Event loop failed.\n";
+                return false;
+            }
+            for (const WSAPOLLFD& socket : sockets) {
+                if (socket.revents == 0) continue;
+                SocketHandle handle = static_cast<SocketHandle>(socket.fd);
+                if (handle == listener) {
+                    acceptClients();
+                    continue;
+                }
+                auto it = connections.find(handle);
+                if (it == connections.end()) continue;
+                bool open = true;
+                if (socket.revents & (POLLRDNORM | POLLHUP | POLLERR)) open = receive(*it->second);
+                else if (socket.revents & POLLWRNORM) open = send(*it->second);
+                if (!open) close(handle);
+            }
+            saveIfDue();
+        }
+#else
+        epoll_event events[64];
+        while (!stopping) {
+            int ready = epoll_wait(epollFd, events, 64, kPollMillis);
+            if (ready < 0) {
+                if (errno == EINTR) continue;
+                std::cerr << "Error: Event loop failed.\n";
+                return false;
+            }
+            for (int i = 0; i < ready; ++i) {
+                int handle = events[i].data.fd;
+                if (handle == listener) {
+                    acceptClients();
+                    continue;
+                }
+                auto it = connections.find(handle);
+                if (it == connections.end()) continue;
+                bool open = true;
+                if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) open = receive(*it->second);
+                else if (events[i].events & EPOLLOUT) open = send(*it->second);
+                if (!open) close(handle);
+            }
+            saveIfDue();
+        }
+#endif
+        return true;
+    }
+
+    void TaskServer::saveEvery(const std::string& file, std::chrono::milliseconds interval) {
+        saveFile = file;
+        saveInterval = interval;
+        lastSave = std::chrono::steady_clock::now();
+    }
+
+    void TaskServer::saveIfDue() {
+        if (saveFile.empty() || changed == savedChanges) return;
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        if (now - lastSave < saveInterval) return;
+        // A failed save reports itself; the next change tries again
+        list.saveTasksToFileAsync(saveFile);
+        savedChanges = changed;
+        lastSave = now;
+    }
+
+    void TaskServer::acceptClients() {
+        for (;;) {
+            SocketHandle socket = static_cast<SocketHandle>(accept(listener, nullptr, nullptr));
+            if (socket == static_cast<SocketHandle>(-1)) return;  // none left
+            setNonBlocking(socket);
+            // Replies are already batched; do not hold them back further
+            int on = 1;
+            setsockopt(socket, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&on), sizeof(on));
+
+            std::unique_ptr<Connection> connection = std::make_unique<Connection>(socket, list, replies);
+#ifndef _WIN32
+            epoll_event event{};
+            event.events = EPOLLIN;
+            event.data.fd = socket;
+            if (epoll_ctl(epollFd, EPOLL_CTL_ADD, socket, &event) != 0) {
+                closeSocket(socket);
+                continue;
+            }
+            connection->watched = EPOLLIN;
+#endif
+            connections.emplace(socket, std::move(connection));
+        }
+    }
+
+    bool TaskServer::receive(Connection& connection) {
+        char buffer[kReadSize];
+        bool peerDone = false;
+        for (;;) {
+            int got = recv(connection.socket, buffer, static_cast<int>(sizeof(buffer)), 0);
+            if (got > 0) {
+                connection.input.append(buffer, static_cast<size_t>(got));
+                // Run what has arrived before reading more, so a client
+                // streaming without newlines is cut off at kMaxLine; the
+                // rest stays in the socket for the next round
+                if (static_cast<size_t>(got) < sizeof(buffer) || connection.input.size() > kMaxLine) break;
+                continue;
+            }
+            if (got == 0) {
+                peerDone = true;
+                break;
+            }
+            if (wouldBlock()) break;
+            return false;
+        }
+
+        // Run every complete line, then apply their changes together
+        size_t before = connection.runner.changes();
+        size_t start = 0;
+        while (!connection.closing) {
+            size_t end = connection.input.find('\n', start);
+            if (end == std::string::npos) break;
+            std::string_view line(connection.input.data() + start, end - start);
+            start = end + 1;
+            if (line == "quit" || line == "quit\r") connection.closing = true;
+            else connection.runner.execute(line);
+        }
+        connection.runner.finish();
+        changed += connection.runner.changes() - before;
+        connection.input.erase(0, start);
+        if (connection.closing) connection.input.clear();
+        if (connection.input.size() > kMaxLine) return false;
+
+        connection.output += replies.str();
+        replies.str(std::string());
+        // A client that closed its end still gets its replies
+        if (peerDone) connection.closing = true;
+        return send(connection);
+    }
+
+    bool TaskServer::send(Connection& connection) {
+        while (connection.sent < connection.output.size()) {
+            size_t left = std::min(connection.output.size() - connection.sent, static_cast<size_t>(INT_MAX));
+            int put = ::send(connection.socket, connection.output.data() + connection.sent,
+                static_cast<int>(left), kSendFlags);
+            if (put > 0) {
+                connection.sent += static_cast<size_t>(put);
+                continue;
+            }
+            if (put < 0 && wouldBlock()) break;
+            return false;
+        }
+        if (connection.sent == connection.output.size()) {
+            connection.output.clear();
+            connection.sent = 0;
+            if (connection.closing) return false;
+        }
+        watch(connection);
+        return true;
+    }
+
+    void TaskServer::watch(Connection& connection) {
+#ifndef _WIN32
+        // WSAPoll is handed the wanted events on every round instead
+        unsigned events = (connection.closing ? 0u : static_cast<unsigned>(EPOLLIN))
+            | (connection.output.empty() ? 0u : static_cast<unsigned>(EPOLLOUT));
+        if (events == connection.watched) return;
+        epoll_event event{};
+        event.events = events;
+        event.data.fd = connection.socket;
+        epoll_ctl(epollFd, EPOLL_CTL_MOD, connection.socket, &event);
+        connection.watched = events;
+#else
+        (void)connection;
+#endif
+    }
+
+    void TaskServer::close(SocketHandle socket) {
+#ifndef _WIN32
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, socket, nullptr);
+#endif
+        closeSocket(socket);
+        connections.erase(socket);
+    }
+
+} // end namespace MyLibrary
@@ -0,0 +1,91 @@
+#pragma once
+#ifndef TASKSERVER_H
+#define TASKSERVER_H
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <cstddef>
+#include <cstdint>
+
+#include "mylibrary.h"
+#include "taskcommands.h"
+
+namespace MyLibrary
+{
+    /**
+     * Serves one TaskList over TCP with the TaskCommandRunner line protocol
+     * (plus "quit" to close the connection), so callers pay a round trip
+     * instead of a process start and a file load per operation.
+     *
+     * A single thread runs the event loop: epoll elsewhere, WSAPoll on
+     * Windows. Clients may pipeline: every complete line that arrives in
+     * one read is run before anything is sent back, their changes go
+     * through one applyBatch, and all of their replies leave in one write.
+     */
+    class TaskServer {
+    public:
+        explicit TaskServer(TaskList& list);
+        ~TaskServer();
+
+        TaskServer(const TaskServer&) = delete;
+        TaskServer& operator=(const TaskServer&) = delete;
+
+        // Listen on host:port (port 0 picks a free one)
+        bool listen(const std::string& host, uint16_t port);
+        uint16_t port() const { return boundPort; }
+
+        // Serve until stop() is called; false if the loop failed
+        bool run();
+        // Ask run() to return; safe from other threads and signal handlers
+        void stop() { stopping = true; }
+
+        // Changes applied through the server so far
+        size_t changes() const { return changed; }
+
+        // Without a journal, nothing else keeps the changes if the process
+        // dies: while run() serves, write the list to file in the
+        // background at most once per interval when something changed
+        void saveEvery(const std::string& file, std::chrono::milliseconds interval);
+
+    private:
+#ifdef _WIN32
+        using SocketHandle = uintptr_t;  // SOCKET
+#else
+        using SocketHandle = int;
+#endif
+        struct Connection;
+
+        void acceptClients();
+        // Read what is available and run every complete line. Like send,
+        // returns false once the connection should be closed
+        bool receive(Connection& connection);
+        // Write as much pending output as the socket takes
+        bool send(Connection& connection);
+        void watch(Connection& connection);
+        void close(SocketHandle socket);
+        void saveIfDue();
+
+        TaskList& list;
+        // Every reply is formatted here, then moved to its connection
+        std::ostringstream replies;
+        std::unordered_map<SocketHandle, std::unique_ptr<Connection>> connections;
+        SocketHandle listener = static_cast<SocketHandle>(-1);
+#ifndef _WIN32
+        int epollFd = -1;
+#endif
+        uint16_t boundPort = 0;
+        std::atomic<bool> stopping{ false };
+        size_t changed = 0;
+        std::string saveFile;  // see saveEvery
+        std::chrono::milliseconds saveInterval{ 0 };
+        std::chrono::steady_clock::time_point lastSave;
+        size_t savedChanges = 0;
+    };
+
+} // end namespace MyLibrary
+
+#endif // TASKSERVER_H
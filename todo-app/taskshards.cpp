@@ -0,0 +1,241 @@
+#include "taskshards.h"
+#include "threadpool.h"
+
+#include <algorithm>
+#include <tuple>
+
+namespace MyLibrary
+{
+    namespace
+    {
+        bool validTask(std::string_view description, uint8_t priority) {
+            return !description.empty() && priority >= 1 && priority <= 5;
+        }
+
+        // Fibonacci hash of the ID; shift 64 means a single shard
+        size_t shardFor(int id, unsigned shift) {
+            if (shift >= 64) return 0;
+            return static_cast<size_t>((static_cast<uint64_t>(static_cast<uint32_t>(id)) * 0x9E3779B97F4A7C15ull) >> shift);
+        }
+    }
+
+    /*--------------------- SNAPSHOT --------------------------------------*/
+
+    size_t ConcurrentTaskStore::Snapshot::size() const {
+        size_t total = 0;
+        for (const ShardPtr& shard : shards) total += shard->size();
+        return total;
+    }
+
+    bool ConcurrentTaskStore::Snapshot::find(int id, const TaskStore*& store, size_t& slot) const {
+        const TaskStore& shard = *shards[shardFor(id, shift)];
+        size_t found = shard.find(id);
+        if (found == TaskIndex::npos) return false;
+        store = &shard;
+        slot = found;
+        return true;
+    }
+
+    /*--------------------- CONSTRUCTION ----------------------------------*/
+
+    ConcurrentTaskStore::ConcurrentTaskStore(size_t shardCount) {
+        // Round up to a power of two so the hash can pick a shard by shifting
+        unsigned bits = 0;
+        while ((size_t(1) << bits) < shardCount && bits < 16) ++bits;
+        count = size_t(1) << bits;
+        shift = 64 - bits;
+        shards.reset(new Shard[count]);
+        for (size_t i = 0; i < count; ++i) shards[i].current = std::make_shared<TaskStore>();
+    }
+
+    ConcurrentTaskStore::ConcurrentTaskStore(const TaskStore& source, int firstFreeId, size_t shardCount)
+        : ConcurrentTaskStore(shardCount)
+    {
+        std::vector<std::shared_ptr<TaskStore>> built(count);
+        for (size_t i = 0; i < count; ++i) built[i] = std::make_shared<TaskStore>();
+        int maxId = 0;
+        for (size_t slot = 0; slot < source.size(); ++slot) {
+            int id = source.id(slot);
+            built[shardFor(id, shift)]->push(id, source.description(slot), source.priority(slot),
+                source.completed(slot), source.dueDate(slot));
+            maxId = std::max(maxId, id);
+        }
+        for (size_t i = 0; i < count; ++i) shards[i].current = std::move(built[i]);
+        nextId = std::max(firstFreeId, maxId + 1);
+    }
+
+    /*--------------------- WRITERS ---------------------------------------*/
+
+    size_t ConcurrentTaskStore::shardOf(int id) const {
+        return shardFor(id, shift);
+    }
+
+    bool ConcurrentTaskStore::modify(size_t index, const std::function<bool(TaskStore&)>& change) {
+        Shard& shard = shards[index];
+        std::lock_guard<std::mutex> lock(shard.writer);
+        std::shared_ptr<TaskStore> copy = std::make_shared<TaskStore>(*shard.current);
+        if (!change(*copy)) return false;
+        std::atomic_store(&shard.current, ShardPtr(std::move(copy)));
+        return true;
+    }
+
+    void ConcurrentTaskStore::raiseNextId(int id) {
+        int current = nextId.load();
+        while (current <= id && !nextId.compare_exchange_weak(current, id + 1)) {
+        }
+    }
+
+    int ConcurrentTaskStore::add(std::string_view description, uint8_t priority, time_t dueDate, bool completed) {
+        if (!validTask(description, priority)) return 0;
+        int id = nextId.fetch_add(1);
+        modify(shardOf(id), [&](TaskStore& store) {
+            store.push(id, description, priority, completed, dueDate);
+            return true;
+        });
+        return id;
+    }
+
+    bool ConcurrentTaskStore::insert(int id, std::string_view description, uint8_t priority, bool completed, time_t dueDate) {
+        if (!validTask(description, priority)) return false;
+        size_t index = shardOf(id);
+        if (shard(index)->find(id) != TaskIndex::npos) return false;
+        bool inserted = modify(index, [&](TaskStore& store) {
+            // Checked again under the lock: another writer may have won
+            if (store.find(id) != TaskIndex::npos) return false;
+            store.push(id, description, priority, completed, dueDate);
+            return true;
+        });
+        if (inserted) raiseNextId(id);
+        return inserted;
+    }
+
+    bool ConcurrentTaskStore::update(int id,
+        std::optional<std::string_view> description,
+        std::optional<uint8_t> priority,
+        std::optional<bool> completed,
+        std::optional<time_t> dueDate)
+    {
+        if ((description && description->empty()) || (priority && (*priority < 1 || *priority > 5))) return false;
+        size_t index = shardOf(id);
+        if (shard(index)->find(id) == TaskIndex::npos) return false;
+        return modify(index, [&](TaskStore& store) {
+            size_t slot = store.find(id);
+            if (slot == TaskIndex::npos) return false;
+            if (description) store.setDescription(slot, *description);
+            if (priority) store.setPriority(slot, *priority);
+            if (completed) store.setCompleted(slot, *completed);
+            if (dueDate) store.setDueDate(slot, *dueDate);
+            return true;
+        });
+    }
+
+    bool ConcurrentTaskStore::remove(int id) {
+        size_t index = shardOf(id);
+        if (shard(index)->find(id) == TaskIndex::npos) return false;
+        return modify(index, [&](TaskStore& store) {
+            size_t slot = store.find(id);
+            if (slot == TaskIndex::npos) return false;
+            // Order inside a shard carries no meaning, so close the gap in O(1)
+            store.eraseSwapLast(slot);
+            return true;
+        });
+    }
+
+    size_t ConcurrentTaskStore::insertAll(const TaskRows& rows) {
+        std::vector<std::vector<size_t>> byShard(count);
+        for (size_t row = 0; row < rows.size(); ++row) {
+            if (validTask(rows.descriptions[row], rows.priorities[row])) {
+                byShard[shardOf(rows.ids[row])].push_back(row);
+            }
+        }
+
+        std::vector<size_t> touched;
+        for (size_t i = 0; i < count; ++i) {
+            if (!byShard[i].empty()) touched.push_back(i);
+        }
+        std::atomic<size_t> inserted{ 0 };
+        std::atomic<int> maxId{ 0 };
+        parallelFor(touched.size(), [&](size_t chunk) {
+            size_t index = touched[chunk];
+            modify(index, [&](TaskStore& store) {
+                size_t added = 0;
+                for (size_t row : byShard[index]) {
+                    int id = rows.ids[row];
+                    if (store.find(id) != TaskIndex::npos) continue;
+                    store.push(id, rows.descriptions[row], rows.priorities[row],
+                        rows.completed[row] != 0, rows.dueDates[row]);
+                    int seen = maxId.load();
+                    while (seen < id && !maxId.compare_exchange_weak(seen, id)) {
+                    }
+                    ++added;
+                }
+                inserted += added;
+                return added > 0;
+            });
+        });
+        if (inserted > 0) raiseNextId(maxId.load());
+        return inserted;
+    }
+
+    /*--------------------- READERS ---------------------------------------*/
+
+    ConcurrentTaskStore::ShardPtr ConcurrentTaskStore::shard(size_t index) const {
+        return std::atomic_load(&shards[index].current);
+    }
+
+    ConcurrentTaskStore::Snapshot ConcurrentTaskStore::snapshot() const {
+        Snapshot view;
+        view.shift = shift;
+        view.shards.reserve(count);
+        for (size_t i = 0; i < count; ++i) view.shards.push_back(shard(i));
+        return view;
+    }
+
+    size_t ConcurrentTaskStore::size() const {
+        size_t total = 0;
+        for (size_t i = 0; i < count; ++i) total += shard(i)->size();
+        return total;
+    }
+
+    TaskStats ConcurrentTaskStore::stats(time_t now) const {
+        TaskStats stats;
+        for (size_t i = 0; i < count; ++i) {
+            ShardPtr current = shard(i);
+            const TaskCounters& counters = current->counters();
+            stats.total += counters.total();
+            stats.completed += counters.completed();
+            for (uint8_t p = 1; p <= 5; ++p) stats.byPriority[p - 1] += counters.withPriority(p);
+            // overdue() would move the shared cursor; readers must not write
+            stats.overdue += counters.overdueAt(now);
+        }
+        stats.pending = stats.total - stats.completed;
+        return stats;
+    }
+
+    size_t ConcurrentTaskStore::countMatching(const TaskFilter& filter) const {
+        size_t total = 0;
+        for (size_t i = 0; i < count; ++i) total += MyLibrary::countMatching(*shard(i), filter);
+        return total;
+    }
+
+    void ConcurrentTaskStore::exportTo(TaskStore& target) const {
+        Snapshot view = snapshot();
+        std::vector<std::tuple<int, size_t, size_t>> order;  // id, shard, slot
+        order.reserve(view.size());
+        for (size_t i = 0; i < view.shardCount(); ++i) {
+            const TaskStore& store = view.shard(i);
+            for (size_t slot = 0; slot < store.size(); ++slot) order.emplace_back(store.id(slot), i, slot);
+        }
+        std::sort(order.begin(), order.end());
+
+        target.clear();
+        target.reserve(order.size());
+        for (const auto& entry : order) {
+            const TaskStore& store = view.shard(std::get<1>(entry));
+            size_t slot = std::get<2>(entry);
+            target.push(store.id(slot), store.description(slot), store.priority(slot),
+                store.completed(slot), store.dueDate(slot));
+        }
+    }
+
+} // end namespace MyLibrary
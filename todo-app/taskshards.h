@@ -0,0 +1,110 @@
+#pragma once
+#ifndef TASKSHARDS_H
+#define TASKSHARDS_H
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+
+#include "taskstore.h"
+#include "taskstats.h"
+#include "taskkernels.h"
+
+namespace MyLibrary
+{
+    /**
+     * Task store that can be read and written from many threads at once.
+     *
+     * Tasks are spread over a power-of-two number of shards by a hash of
+     * their ID. Each shard is an immutable TaskStore behind a shared_ptr:
+     * readers grab the current pointer and never lock or wait, and a writer
+     * locks only its shard, changes a private copy and publishes it. Writes
+     * to different shards run in parallel; the cost of a write is a copy of
+     * one shard, so insertAll batches many rows into one copy per shard.
+     *
+     * IDs come from an atomic counter, so concurrent adds never collide.
+     */
+    class ConcurrentTaskStore {
+    public:
+        using ShardPtr = std::shared_ptr<const TaskStore>;
+
+        /**
+         * Every shard as it was when the snapshot was taken (per shard, not
+         * across shards). Holding one keeps those versions alive.
+         */
+        class Snapshot {
+        public:
+            size_t shardCount() const { return shards.size(); }
+            const TaskStore& shard(size_t index) const { return *shards[index]; }
+            size_t size() const;
+            // Shard and slot of the task with that ID, if there is one
+            bool find(int id, const TaskStore*& store, size_t& slot) const;
+
+        private:
+            friend class ConcurrentTaskStore;
+            std::vector<ShardPtr> shards;
+            unsigned shift = 0;
+        };
+
+        explicit ConcurrentTaskStore(size_t shardCount = 64);
+        // Start from a copy of a single-threaded store
+        ConcurrentTaskStore(const TaskStore& source, int nextId, size_t shardCount = 64);
+
+        ConcurrentTaskStore(const ConcurrentTaskStore&) = delete;
+        ConcurrentTaskStore& operator=(const ConcurrentTaskStore&) = delete;
+
+        // ---------- Writers ----------
+        // New task with the next ID; 0 if the description or priority is invalid
+        int add(std::string_view description, uint8_t priority, time_t dueDate, bool completed = false);
+        // Task with a given ID; false if it is invalid or the ID is taken
+        bool insert(int id, std::string_view description, uint8_t priority, bool completed, time_t dueDate);
+        // Set the given fields; false if there is no such task or a value is invalid
+        bool update(int id,
+            std::optional<std::string_view> description = {},
+            std::optional<uint8_t> priority = {},
+            std::optional<bool> completed = {},
+            std::optional<time_t> dueDate = {});
+        bool remove(int id);
+        // Insert rows with one copy per shard touched; returns how many
+        // were new (rows with a taken ID are skipped)
+        size_t insertAll(const TaskRows& rows);
+
+        // ---------- Readers (never block) ----------
+        Snapshot snapshot() const;
+        ShardPtr shard(size_t index) const;
+        size_t shardCount() const { return count; }
+        size_t size() const;
+        TaskStats stats(time_t now = std::time(nullptr)) const;
+        size_t countMatching(const TaskFilter& filter) const;
+        // Copy every task into target, ordered by ID
+        void exportTo(TaskStore& target) const;
+
+        int peekNextId() const { return nextId.load(); }
+
+    private:
+        struct Shard {
+            std::mutex writer;  // serialises copy-and-publish
+            ShardPtr current;
+        };
+
+        size_t shardOf(int id) const;
+        // Run change on a copy of the shard and publish it if it returns true
+        bool modify(size_t index, const std::function<bool(TaskStore&)>& change);
+        void raiseNextId(int id);
+
+        std::unique_ptr<Shard[]> shards;
+        size_t count;
+        unsigned shift;
+        std::atomic<int> nextId{ 1 };
+    };
+
+} // end namespace MyLibrary
+
+#endif // TASKSHARDS_H
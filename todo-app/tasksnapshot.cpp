@@ -0,0 +1,560 @@
+#include "mylibrary.h"
+#include "taskcompress.h"
+#include "threadpool.h"
+
+#include <cstdint>
+#include <cstddef>
+#include <unordered_map>
+
+namespace MyLibrary
+{
+    /*--------------------- SNAPSHOT FORMAT ---------------------------------*/
+    // Binary snapshot layout (native little-endian, every section 8-byte aligned):
+    //   SnapshotHeader
+    //   int64_t  dueDate[taskCount]
+    //   int32_t  id[taskCount]
+    //   uint32_t descIndex[taskCount]         // v3: entry in the string table
+    //   uint8_t  priority[taskCount]
+    //   uint8_t  completed[taskCount]
+    //   uint32_t stringOffset[stringCount + 1] // v3: into the description blob
+    //   char     descriptions[blobSize]      // each distinct text once, no terminators
+    // Versions 1 and 2 have no string table: descIndex is replaced by
+    // uint32_t descOffset[taskCount + 1] and every row has its own text.
+    //
+    // Version 4 (setSnapshotCompression) keeps the header and replaces the
+    // columns with blocks of up to kRowsPerBlock rows, each compressed on
+    // its own (taskcompress.h) so they can be decoded in parallel:
+    //   SnapshotHeader                  // blobSize = bytes of all blocks
+    //   { BlockHeader, packed bytes }[blockCount]
+    // where a block holds, before compression:
+    //   varint  id delta[rowCount]       // zigzag, from the previous row
+    //   varint  dueDate delta[rowCount]  // zigzag
+    //   uint8_t flags[(rowCount + 1) / 2] // a nibble per row: priority | completed << 3
+    //   varint  descLength[rowCount]
+    //   char    descriptions[]           // no terminators
+    // A block whose packedSize equals its rawSize is stored as is. Every row
+    // takes at least one byte, and no block has more than kRowsPerBlock.
+    namespace
+    {
+        const char kSnapshotMagic[8] = { 'T', 'O', 'D', 'O', 'S', 'N', 'A', 'P' };
+        const uint32_t kSnapshotVersion = 3;
+        const uint32_t kCompressedSnapshotVersion = 4;
+        const size_t kRowsPerBlock = 16384;
+        // The most an LZ4-style block can expand: each length byte adds 255
+        const uint64_t kMaxExpansion = 255;
+
+        struct SnapshotHeader {
+            char magic[8];
+            uint32_t version;
+            uint32_t headerSize;
+            uint64_t taskCount;
+            int32_t nextId;
+            uint32_t reserved;
+            uint64_t blobSize;
+            uint64_t journalSeq;   // v2: last journal record folded in
+            uint64_t stringCount;  // v3: entries in the string table
+            uint64_t blockCount;   // v4: compressed row blocks
+        };
+
+        // Older headers end before the fields they did not have yet
+        const size_t kSnapshotV1HeaderSize = offsetof(SnapshotHeader, journalSeq);
+        const size_t kSnapshotV2HeaderSize = offsetof(SnapshotHeader, stringCount);
+        const size_t kSnapshotV3HeaderSize = offsetof(SnapshotHeader, blockCount);
+
+        size_t headerSizeFor(uint32_t version) {
+            return version == 1 ? kSnapshotV1HeaderSize
+                : version == 2 ? kSnapshotV2HeaderSize
+                : version == 3 ? kSnapshotV3HeaderSize : sizeof(SnapshotHeader);
+        }
+
+        struct BlockHeader {
+            uint32_t rawSize;
+            uint32_t packedSize;
+            uint32_t rowCount;
+            uint32_t reserved;
+        };
+
+        size_t align8(size_t n) {
+            return (n + 7) & ~static_cast<size_t>(7);
+        }
+
+        // Byte offsets of each column for a snapshot with n tasks. For v1/v2
+        // files descriptions is the per-row offset table and strings is empty.
+        struct SnapshotLayout {
+            size_t dueDates, ids, descriptions, priorities, completed, strings, blob, end;
+
+            SnapshotLayout(uint32_t version, size_t n, size_t stringCount, size_t blobSize) {
+                bool table = version >= 3;
+                dueDates = align8(headerSizeFor(version));
+                ids = align8(dueDates + n * sizeof(int64_t));
+                descriptions = align8(ids + n * sizeof(int32_t));
+                priorities = align8(descriptions + (table ? n : n + 1) * sizeof(uint32_t));
+                completed = align8(priorities + n);
+                strings = align8(completed + n);
+                blob = table ? align8(strings + (stringCount + 1) * sizeof(uint32_t)) : strings;
+                end = blob + blobSize;
+            }
+        };
+
+        void putVarint(std::string& out, uint64_t value) {
+            while (value >= 0x80) {
+                out.push_back(static_cast<char>(value | 0x80));
+                value >>= 7;
+            }
+            out.push_back(static_cast<char>(value));
+        }
+
+        bool getVarint(const uint8_t*& p, const uint8_t* end, uint64_t& value) {
+            value = 0;
+            for (unsigned shift = 0; shift < 64; shift += 7) {
+                if (p == end) return false;
+                uint8_t byte = *p++;
+                value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+                if (!(byte & 0x80)) return true;
+            }
+            return false;
+        }
+
+        // Deltas wrap in unsigned arithmetic; zigzag keeps small negative
+        // ones short
+        uint64_t deltaCode(int64_t value, int64_t previous) {
+            int64_t delta = static_cast<int64_t>(static_cast<uint64_t>(value) - static_cast<uint64_t>(previous));
+            return (static_cast<uint64_t>(delta) << 1) ^ static_cast<uint64_t>(delta >> 63);
+        }
+
+        int64_t applyDelta(int64_t previous, uint64_t code) {
+            uint64_t delta = (code >> 1) ^ (0 - (code & 1));
+            return static_cast<int64_t>(static_cast<uint64_t>(previous) + delta);
+        }
+
+        // Uncompressed bytes of one block of rows from source
+        std::string encodeBlock(const TaskColumns& source, const size_t* slots, size_t rows) {
+            std::string raw;
+            int64_t previous = 0;
+            for (size_t i = 0; i < rows; ++i) {
+                int64_t id = source.id(slots[i]);
+                putVarint(raw, deltaCode(id, previous));
+                previous = id;
+            }
+            previous = 0;
+            for (size_t i = 0; i < rows; ++i) {
+                int64_t due = source.dueDate(slots[i]);
+                putVarint(raw, deltaCode(due, previous));
+                previous = due;
+            }
+            for (size_t i = 0; i < rows; i += 2) {
+                uint8_t flags = 0;
+                for (size_t j = i; j < i + 2 && j < rows; ++j) {
+                    uint8_t nibble = static_cast<uint8_t>(source.priority(slots[j]) | (source.completed(slots[j]) ? 8 : 0));
+                    flags |= static_cast<uint8_t>(nibble << ((j - i) * 4));
+                }
+                raw.push_back(static_cast<char>(flags));
+            }
+            for (size_t i = 0; i < rows; ++i) putVarint(raw, source.description(slots[i]).size());
+            for (size_t i = 0; i < rows; ++i) raw.append(source.description(slots[i]));
+            return raw;
+        }
+
+        // One block after decompression; descriptions point into raw
+        struct DecodedBlock {
+            std::string raw;
+            std::vector<int32_t> ids;
+            std::vector<int64_t> dueDates;
+            std::vector<uint8_t> flags;
+            std::vector<std::string_view> descriptions;
+        };
+
+        bool decodeBlock(const char* packed, const BlockHeader& header, DecodedBlock& out) {
+            size_t rows = header.rowCount;
+            out.raw.resize(header.rawSize);
+            if (header.packedSize == header.rawSize) {
+                std::memcpy(&out.raw[0], packed, header.rawSize);
+            }
+            else if (!decompressBlock(packed, header.packedSize, &out.raw[0], header.rawSize)) {
+                return false;
+            }
+
+            const uint8_t* p = reinterpret_cast<const uint8_t*>(out.raw.data());
+            const uint8_t* end = p + out.raw.size();
+            out.ids.resize(rows);
+            out.dueDates.resize(rows);
+            out.flags.resize(rows);
+            out.descriptions.resize(rows);
+            uint64_t code;
+            int64_t previous = 0;
+            for (size_t i = 0; i < rows; ++i) {
+                if (!getVarint(p, end, code)) return false;
+                previous = applyDelta(previous, code);
+                // Out-of-range IDs are caught with the other invalid rows
+                out.ids[i] = previous > 0 && previous <= INT32_MAX ? static_cast<int32_t>(previous) : 0;
+            }
+            previous = 0;
+            for (size_t i = 0; i < rows; ++i) {
+                if (!getVarint(p, end, code)) return false;
+                previous = applyDelta(previous, code);
+                out.dueDates[i] = previous;
+            }
+            if (static_cast<size_t>(end - p) < (rows + 1) / 2) return false;
+            for (size_t i = 0; i < rows; ++i) out.flags[i] = (p[i / 2] >> ((i % 2) * 4)) & 15;
+            p += (rows + 1) / 2;
+
+            std::vector<uint64_t> lengths(rows);
+            uint64_t textBytes = 0;
+            for (size_t i = 0; i < rows; ++i) {
+                if (!getVarint(p, end, lengths[i])) return false;
+                textBytes += lengths[i];
+            }
+            if (textBytes != static_cast<uint64_t>(end - p)) return false;
+            const char* text = reinterpret_cast<const char*>(p);
+            for (size_t i = 0; i < rows; ++i) {
+                out.descriptions[i] = std::string_view(text, static_cast<size_t>(lengths[i]));
+                text += lengths[i];
+            }
+            return true;
+        }
+
+        // Version 4 buffer for the given rows of source
+        std::vector<char> buildCompressedSnapshot(const TaskColumns& source, const std::vector<size_t>& valid,
+            int next, uint64_t seq)
+        {
+            size_t n = valid.size();
+            size_t blockCount = (n + kRowsPerBlock - 1) / kRowsPerBlock;
+            std::vector<std::string> packed(blockCount);
+            std::vector<BlockHeader> blocks(blockCount);
+            parallelFor(blockCount, [&](size_t b) {
+                size_t first = b * kRowsPerBlock;
+                size_t rows = std::min(kRowsPerBlock, n - first);
+                std::string raw = encodeBlock(source, valid.data() + first, rows);
+                size_t rawSize = raw.size();
+                if (rawSize > UINT32_MAX) return;  // rowCount stays 0; reported below
+                std::string& out = packed[b];
+                out.resize(compressBound(rawSize));
+                out.resize(compressBlock(raw.data(), rawSize, &out[0]));
+                if (out.size() >= rawSize) out = std::move(raw);
+                blocks[b] = { static_cast<uint32_t>(rawSize), static_cast<uint32_t>(out.size()),
+                    static_cast<uint32_t>(rows), 0 };
+            });
+
+            size_t payload = 0;
+            for (size_t b = 0; b < blockCount; ++b) {
+                if (blocks[b].rowCount == 0) {
+                    std::cerr << "Error: Descriptions too large for snapshot format.\n";
+                    return {};
+                }
+                payload += sizeof(BlockHeader) + packed[b].size();
+            }
+
+            size_t start = align8(sizeof(SnapshotHeader));
+            std::vector<char> buffer(start + payload, 0);
+            SnapshotHeader header{};
+            std::memcpy(header.magic, kSnapshotMagic, sizeof(kSnapshotMagic));
+            header.version = kCompressedSnapshotVersion;
+            header.headerSize = sizeof(header);
+            header.taskCount = n;
+            header.nextId = next;
+            header.blobSize = payload;
+            header.journalSeq = seq;
+            header.blockCount = blockCount;
+            std::memcpy(buffer.data(), &header, sizeof(header));
+
+            char* out = buffer.data() + start;
+            for (size_t b = 0; b < blockCount; ++b) {
+                std::memcpy(out, &blocks[b], sizeof(BlockHeader));
+                out += sizeof(BlockHeader);
+                std::memcpy(out, packed[b].data(), packed[b].size());
+                out += packed[b].size();
+            }
+            return buffer;
+        }
+    }
+
+    bool TaskList::isSnapshotData(std::string_view data) {
+        return data.size() >= sizeof(kSnapshotMagic)
+            && std::memcmp(data.data(), kSnapshotMagic, sizeof(kSnapshotMagic)) == 0;
+    }
+
+    bool TaskList::loadSnapshotData(std::string_view data) {
+        TODO_TIME_SCOPE(METRIC_SNAPSHOT_LOAD);
+        SnapshotHeader header{};
+        if (data.size() < kSnapshotV1HeaderSize) {
+            std::cerr << "Error: Snapshot file is truncated.\n";
+            return false;
+        }
+        std::memcpy(&header, data.data(), kSnapshotV1HeaderSize);
+        if (!isSnapshotData(data) || header.version < 1 || header.version > kCompressedSnapshotVersion
+            || header.headerSize != headerSizeFor(header.version) || data.size() < header.headerSize) {
+            std::cerr << "Error: Unsupported snapshot format.\n";
+            return false;
+        }
+        std::memcpy(&header, data.data(), header.headerSize);
+        if (header.version == kCompressedSnapshotVersion) return loadCompressedSnapshot(data);
+
+        size_t n = static_cast<size_t>(header.taskCount);
+        bool table = header.version >= 3;
+        // Older files give every row its own offset range: treat that as a
+        // table with one string per row, indexed by row number
+        size_t stringCount = table ? static_cast<size_t>(header.stringCount) : n;
+        if (n > data.size() || stringCount > data.size()) {
+            std::cerr << "Error: Snapshot file is truncated.\n";
+            return false;
+        }
+        SnapshotLayout layout(header.version, n, stringCount, static_cast<size_t>(header.blobSize));
+        if (layout.end > data.size()) {
+            std::cerr << "Error: Snapshot file is truncated.\n";
+            return false;
+        }
+
+        const char* base = data.data();
+        std::vector<int64_t> dueDates(n);
+        std::vector<int32_t> ids(n);
+        std::vector<uint32_t> offsets(stringCount + 1);
+        std::vector<uint32_t> descIndex(n);
+        std::memcpy(dueDates.data(), base + layout.dueDates, n * sizeof(int64_t));
+        std::memcpy(ids.data(), base + layout.ids, n * sizeof(int32_t));
+        if (table) {
+            std::memcpy(descIndex.data(), base + layout.descriptions, n * sizeof(uint32_t));
+            std::memcpy(offsets.data(), base + layout.strings, (stringCount + 1) * sizeof(uint32_t));
+        }
+        else {
+            for (size_t i = 0; i < n; ++i) descIndex[i] = static_cast<uint32_t>(i);
+            std::memcpy(offsets.data(), base + layout.descriptions, (n + 1) * sizeof(uint32_t));
+        }
+        const uint8_t* priorities = reinterpret_cast<const uint8_t*>(base + layout.priorities);
+        const uint8_t* completed = reinterpret_cast<const uint8_t*>(base + layout.completed);
+        const char* blob = base + layout.blob;
+
+        tasks.clear();
+        tasks.reserve(n, header.blobSize);
+        int maxID = 0;
+        for (size_t i = 0; i < n; ++i) {
+            uint32_t s = descIndex[i];
+            if (s >= stringCount || offsets[s] > offsets[s + 1] || offsets[s + 1] > header.blobSize
+                || priorities[i] < HIGHEST || priorities[i] > LOWEST || ids[i] <= 0
+                || tasks.find(ids[i]) != TaskIndex::npos) {
+                std::cerr << "Skipping invalid task from snapshot.\n";
+                continue;
+            }
+            std::string_view desc(blob + offsets[s], offsets[s + 1] - offsets[s]);
+            insertTask(ids[i], desc, static_cast<Priority>(priorities[i]),
+                completed[i] != 0, static_cast<time_t>(dueDates[i]));
+            if (ids[i] > maxID) maxID = ids[i];
+        }
+        nextId = std::max(maxID + 1, static_cast<int>(header.nextId));
+        journalSeq = header.journalSeq;
+        return true;
+    }
+
+    bool TaskList::loadCompressedSnapshot(std::string_view data) {
+        SnapshotHeader header{};
+        std::memcpy(&header, data.data(), sizeof(header));
+
+        // Find every block first so a bad file is rejected before the
+        // current tasks are thrown away
+        std::vector<BlockHeader> blocks;
+        std::vector<const char*> packed;
+        size_t pos = align8(sizeof(header));
+        uint64_t rows = 0;
+        uint64_t rawBytes = 0;
+        for (uint64_t b = 0; b < header.blockCount; ++b) {
+            BlockHeader block;
+            if (pos > data.size() || data.size() - pos < sizeof(block)) break;
+            std::memcpy(&block, data.data() + pos, sizeof(block));
+            pos += sizeof(block);
+            if (data.size() - pos < block.packedSize) break;
+            // Sizes come from the file; bound them before anything is
+            // allocated from them
+            if (block.rowCount > kRowsPerBlock || block.rowCount > block.rawSize
+                || (block.packedSize != block.rawSize
+                    && block.rawSize > block.packedSize * kMaxExpansion + 16)) {
+                std::cerr << "Error: Snapshot file is corrupt.\n";
+                return false;
+            }
+            blocks.push_back(block);
+            packed.push_back(data.data() + pos);
+            pos += block.packedSize;
+            rows += block.rowCount;
+            rawBytes += block.rawSize;
+        }
+        if (blocks.size() != header.blockCount || rows != header.taskCount) {
+            std::cerr << "Error: Snapshot file is truncated.\n";
+            return false;
+        }
+        if (rows > static_cast<uint64_t>(INT32_MAX)) {
+            std::cerr << "Error: Snapshot file is corrupt.\n";
+            return false;
+        }
+
+        tasks.clear();
+        // The totals are still only claims until the blocks decode, so the
+        // reservation is capped by what a file this size plausibly holds;
+        // past that the columns just grow
+        tasks.reserve(static_cast<size_t>(std::min<uint64_t>(rows, data.size())),
+            static_cast<size_t>(std::min<uint64_t>(rawBytes, data.size() * 16)));
+        // Decode a few blocks per thread at a time, so memory stays bounded
+        // by the batch rather than the whole snapshot
+        size_t batch = std::max<size_t>(1, parallelism()) * 2;
+        std::vector<DecodedBlock> decoded(std::min(batch, blocks.size()));
+        std::vector<char> decodedOk(decoded.size());
+        int maxID = 0;
+        for (size_t first = 0; first < blocks.size(); first += batch) {
+            size_t count = std::min(batch, blocks.size() - first);
+            parallelFor(count, [&](size_t i) {
+                decodedOk[i] = decodeBlock(packed[first + i], blocks[first + i], decoded[i]);
+            });
+            for (size_t i = 0; i < count; ++i) {
+                if (!decodedOk[i]) {
+                    std::cerr << "Error: Snapshot file is corrupt.\n";
+                    tasks.clear();
+                    return false;
+                }
+                const DecodedBlock& block = decoded[i];
+                for (size_t row = 0; row < block.ids.size(); ++row) {
+                    int id = block.ids[row];
+                    uint8_t prio = block.flags[row] & 7;
+                    if (prio < HIGHEST || prio > LOWEST || id <= 0 || tasks.find(id) != TaskIndex::npos) {
+                        std::cerr << "Skipping invalid task from snapshot.\n";
+                        continue;
+                    }
+                    insertTask(id, block.descriptions[row], static_cast<Priority>(prio),
+                        (block.flags[row] & 8) != 0, static_cast<time_t>(block.dueDates[row]));
+                    if (id > maxID) maxID = id;
+                }
+            }
+        }
+        nextId = std::max(maxID + 1, static_cast<int>(header.nextId));
+        journalSeq = header.journalSeq;
+        return true;
+    }
+
+    void TaskList::loadTasksFromSnapshot(const std::string& filename) {
+        auto start = std::chrono::steady_clock::now();
+
+        MappedFile file;
+        if (!file.open(filename)) {
+            // Same as the text loader: a missing file just means no tasks yet
+            return;
+        }
+        if (loadSnapshotData(file.view())) finishLoadStats(start, file.size());
+    }
+
+    std::vector<char> TaskList::buildSnapshot(const TaskColumns& source, int next, uint64_t seq, bool compressed) {
+        // Give each distinct description a string table entry, in order of
+        // first use. Interned stores already have one handle per text.
+        // Compressed blocks store the text per row and leave repeats to
+        // the compressor.
+        std::vector<size_t> valid;
+        std::vector<uint32_t> descIndex;
+        std::vector<std::string_view> strings;
+        valid.reserve(source.size());
+        descIndex.reserve(source.size());
+        std::vector<uint32_t> indexOfHandle;
+        std::unordered_map<std::string_view, uint32_t> indexOfText;
+        const std::vector<DescriptionPool::Handle>& handles = source.descriptionColumn();
+        size_t blobSize = 0;
+        for (size_t slot = 0; slot < source.size(); ++slot) {
+            std::string_view desc = source.description(slot);
+            if (!validateTask(desc, static_cast<Priority>(source.priority(slot)))) {
+                std::cerr << "Error: Invalid Task with ID " << source.id(slot) << " - not saved.\n";
+                continue;
+            }
+            if (compressed) {
+                valid.push_back(slot);
+                continue;
+            }
+            uint32_t fresh = static_cast<uint32_t>(strings.size());
+            uint32_t index;
+            if (source.interned()) {
+                DescriptionPool::Handle handle = handles[slot];
+                if (handle >= indexOfHandle.size()) indexOfHandle.resize(handle + 1, UINT32_MAX);
+                if (indexOfHandle[handle] == UINT32_MAX) indexOfHandle[handle] = fresh;
+                index = indexOfHandle[handle];
+            }
+            else {
+                index = indexOfText.emplace(desc, fresh).first->second;
+            }
+            if (index == fresh) {
+                strings.push_back(desc);
+                blobSize += desc.size();
+            }
+            valid.push_back(slot);
+            descIndex.push_back(index);
+        }
+        if (compressed) return buildCompressedSnapshot(source, valid, next, seq);
+        if (blobSize > UINT32_MAX) {
+            std::cerr << "Error: Descriptions too large for snapshot format.\n";
+            return {};
+        }
+
+        size_t n = valid.size();
+        SnapshotLayout layout(kSnapshotVersion, n, strings.size(), blobSize);
+        std::vector<char> buffer(layout.end, 0);
+        char* base = buffer.data();
+
+        SnapshotHeader header{};
+        std::memcpy(header.magic, kSnapshotMagic, sizeof(kSnapshotMagic));
+        header.version = kSnapshotVersion;
+        header.headerSize = kSnapshotV3HeaderSize;
+        header.taskCount = n;
+        header.nextId = next;
+        header.blobSize = blobSize;
+        header.journalSeq = seq;
+        header.stringCount = strings.size();
+        std::memcpy(base, &header, kSnapshotV3HeaderSize);
+
+        for (size_t i = 0; i < n; ++i) {
+            size_t slot = valid[i];
+            int64_t due = source.dueDate(slot);
+            int32_t id = source.id(slot);
+            std::memcpy(base + layout.dueDates + i * sizeof(int64_t), &due, sizeof(due));
+            std::memcpy(base + layout.ids + i * sizeof(int32_t), &id, sizeof(id));
+            std::memcpy(base + layout.descriptions + i * sizeof(uint32_t), &descIndex[i], sizeof(uint32_t));
+            base[layout.priorities + i] = static_cast<char>(source.priority(slot));
+            base[layout.completed + i] = source.completed(slot) ? 1 : 0;
+        }
+
+        uint32_t offset = 0;
+        for (size_t i = 0; i < strings.size(); ++i) {
+            std::memcpy(base + layout.strings + i * sizeof(uint32_t), &offset, sizeof(offset));
+            std::memcpy(base + layout.blob + offset, strings[i].data(), strings[i].size());
+            offset += static_cast<uint32_t>(strings[i].size());
+        }
+        std::memcpy(base + layout.strings + strings.size() * sizeof(uint32_t), &offset, sizeof(offset));
+        return buffer;
+    }
+
+    bool TaskList::writeSnapshot(const std::string& filename, const std::vector<char>& buffer) {
+        if (buffer.empty()) return false;
+        if (!writeFileAtomically(filename, buffer.data(), buffer.size())) {
+            std::cerr << "Error: Failed to write snapshot " << filename << ".\n";
+            return false;
+        }
+        return true;
+    }
+
+    bool TaskList::readSnapshotHeader(const std::string& filename, int& next, uint64_t& seq) {
+        std::ifstream in(filename, std::ios::binary);
+        if (!in) return true;  // no snapshot yet
+        SnapshotHeader header{};
+        in.read(reinterpret_cast<char*>(&header), sizeof(header));
+        size_t got = static_cast<size_t>(in.gcount());
+        if (got < kSnapshotV1HeaderSize || std::memcmp(header.magic, kSnapshotMagic, sizeof(kSnapshotMagic)) != 0
+            || header.version < 1 || header.version > kCompressedSnapshotVersion
+            || header.headerSize != headerSizeFor(header.version) || got < header.headerSize) {
+            std::cerr << "Error: Unsupported snapshot format.\n";
+            return false;
+        }
+        next = std::max(next, static_cast<int>(header.nextId));
+        if (header.version >= 2) seq = header.journalSeq;
+        return true;
+    }
+
+    void TaskList::saveTasksToSnapshot(const std::string& filename) {
+        TODO_TIME_SCOPE(METRIC_SNAPSHOT_SAVE);
+        writeSnapshot(filename, buildSnapshot(tasks.columns(), nextId, journalSeq, compressSnapshots));
+    }
+
+    void TaskList::setSnapshotCompression(bool on) {
+        compressSnapshots = on;
+    }
+
+} // end namespace MyLibrary
@@ -0,0 +1,135 @@
+#include "tasksort.h"
+#include "threadpool.h"
+
+namespace MyLibrary
+{
+    namespace
+    {
+        const size_t kPriorityBuckets = 256;  // one per possible uint8_t value
+
+        // Map a signed due date onto an unsigned key with the same ordering,
+        // inverted for descending sorts
+        uint64_t radixKey(time_t value, bool ascending) {
+            uint64_t key = static_cast<uint64_t>(static_cast<int64_t>(value)) ^ (uint64_t(1) << 63);
+            return ascending ? key : ~key;
+        }
+
+        const int kDigitBits = 11;  // 2048 buckets: the counts stay in L1
+        const size_t kDigitBuckets = size_t(1) << kDigitBits;
+        const size_t kMinItemsPerChunk = 1 << 16;
+
+        // One stable counting-sort pass over positions [0, n). digit(i) is the
+        // bucket of the item at position i and move(i, dest) places it. Each
+        // chunk counts and scatters its own range; the bucket-major prefix sum
+        // puts chunk c's items after chunk c-1's, which keeps the pass stable.
+        template <typename Digit, typename Move>
+        void distribute(size_t n, size_t buckets, Digit digit, Move move) {
+            size_t chunks = splitWork(n, kMinItemsPerChunk);
+            std::vector<size_t> counts(chunks * buckets, 0);
+            parallelFor(chunks, [&](size_t chunk) {
+                size_t* count = &counts[chunk * buckets];
+                size_t end = chunkBegin(n, chunks, chunk + 1);
+                for (size_t i = chunkBegin(n, chunks, chunk); i < end; ++i) ++count[digit(i)];
+            });
+
+            size_t offset = 0;
+            for (size_t b = 0; b < buckets; ++b) {
+                for (size_t chunk = 0; chunk < chunks; ++chunk) {
+                    size_t& count = counts[chunk * buckets + b];
+                    size_t c = count;
+                    count = offset;
+                    offset += c;
+                }
+            }
+
+            parallelFor(chunks, [&](size_t chunk) {
+                size_t* next = &counts[chunk * buckets];
+                size_t end = chunkBegin(n, chunks, chunk + 1);
+                for (size_t i = chunkBegin(n, chunks, chunk); i < end; ++i) move(i, next[digit(i)]++);
+            });
+        }
+
+        // Stable LSD radix sort of slots by keys[slot]; order holds the input
+        // sequence on entry and the sorted sequence on return
+        void radixSort(const std::vector<uint64_t>& keys, std::vector<size_t>& order) {
+            size_t n = order.size();
+            if (n < 2) return;
+
+            // Sort on the offset from the smallest key, so only the bits that
+            // actually vary need a pass (a few years of dates fit in 3 passes)
+            uint64_t low = keys[0], high = keys[0];
+            for (uint64_t key : keys) {
+                if (key < low) low = key;
+                if (key > high) high = key;
+            }
+            int bits = 0;
+            for (uint64_t span = high - low; span != 0; span >>= 1) ++bits;
+            int passes = (bits + kDigitBits - 1) / kDigitBits;
+            if (passes == 0) return;  // all keys equal
+
+            std::vector<uint64_t> sortedKeys(n);
+            for (size_t i = 0; i < n; ++i) sortedKeys[i] = keys[order[i]] - low;
+
+            std::vector<size_t> scratch(n);
+            std::vector<uint64_t> scratchKeys(n);
+            for (int pass = 0; pass < passes; ++pass) {
+                int shift = pass * kDigitBits;
+                distribute(n, kDigitBuckets,
+                    [&](size_t i) { return static_cast<size_t>((sortedKeys[i] >> shift) & (kDigitBuckets - 1)); },
+                    [&](size_t i, size_t dest) {
+                        scratch[dest] = order[i];
+                        scratchKeys[dest] = sortedKeys[i];
+                    });
+                order.swap(scratch);
+                sortedKeys.swap(scratchKeys);
+            }
+        }
+
+        // Stable counting sort of order by priorities[slot]
+        void countingSort(const std::vector<uint8_t>& priorities, bool ascending, std::vector<size_t>& order) {
+            std::vector<size_t> sorted(order.size());
+            distribute(order.size(), kPriorityBuckets,
+                [&](size_t i) {
+                    uint8_t value = priorities[order[i]];
+                    return static_cast<size_t>(ascending ? value : kPriorityBuckets - 1 - value);
+                },
+                [&](size_t i, size_t dest) { sorted[dest] = order[i]; });
+            order.swap(sorted);
+        }
+
+        void identity(size_t n, std::vector<size_t>& order) {
+            order.resize(n);
+            for (size_t i = 0; i < n; ++i) order[i] = i;
+        }
+
+        void sortByDue(const std::vector<time_t>& dueDates, bool ascending, std::vector<size_t>& order) {
+            std::vector<uint64_t> keys(dueDates.size());
+            for (size_t i = 0; i < dueDates.size(); ++i) keys[i] = radixKey(dueDates[i], ascending);
+            radixSort(keys, order);
+        }
+    }
+
+    void sortSlotsByPriority(const std::vector<uint8_t>& priorities, bool ascending,
+        std::vector<size_t>& order)
+    {
+        identity(priorities.size(), order);
+        countingSort(priorities, ascending, order);
+    }
+
+    void sortSlotsByDueDate(const std::vector<time_t>& dueDates, bool ascending,
+        std::vector<size_t>& order)
+    {
+        identity(dueDates.size(), order);
+        sortByDue(dueDates, ascending, order);
+    }
+
+    void sortSlotsByPriorityThenDueDate(const std::vector<uint8_t>& priorities, bool priorityAscending,
+        const std::vector<time_t>& dueDates, bool dueAscending, std::vector<size_t>& order)
+    {
+        // LSD order: minor key first, then a stable pass on the major key
+        identity(priorities.size(), order);
+        sortByDue(dueDates, dueAscending, order);
+        countingSort(priorities, priorityAscending, order);
+    }
+
+} // end namespace MyLibrary
@@ -0,0 +1,34 @@
+#pragma once
+#ifndef TASKSORT_H
+#define TASKSORT_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+
+namespace MyLibrary
+{
+    /*
+     * Linear-time stable sorts over TaskStore columns. Each fills order so
+     * that order[i] is the slot that belongs at position i; equal keys keep
+     * their current relative order. The result is meant for
+     * TaskStore::permute. Large inputs are counted and scattered in
+     * parallel chunks on the shared thread pool.
+     */
+
+    // Counting sort on the five priority values
+    void sortSlotsByPriority(const std::vector<uint8_t>& priorities, bool ascending,
+        std::vector<size_t>& order);
+
+    // LSD radix sort on the 64-bit due date, 11 bits per pass
+    void sortSlotsByDueDate(const std::vector<time_t>& dueDates, bool ascending,
+        std::vector<size_t>& order);
+
+    // Priority first, due date within each priority
+    void sortSlotsByPriorityThenDueDate(const std::vector<uint8_t>& priorities, bool priorityAscending,
+        const std::vector<time_t>& dueDates, bool dueAscending, std::vector<size_t>& order);
+
+} // end namespace MyLibrary
+
+#endif // TASKSORT_H
@@ -0,0 +1,101 @@
+#include "taskstats.h"
+
+namespace MyLibrary
+{
+    void TaskCounters::clear() {
+        totalCount = 0;
+        completedCount = 0;
+        for (size_t& count : priorityCounts) count = 0;
+        pendingByDue.clear();
+        cursor = std::numeric_limits<time_t>::min();
+        overdueCount = 0;
+    }
+
+    void TaskCounters::add(uint8_t priority, bool completed, time_t dueDate) {
+        ++totalCount;
+        if (priority <= kPriorities) ++priorityCounts[priority];
+        if (completed) ++completedCount;
+        else addPending(dueDate);
+    }
+
+    void TaskCounters::remove(uint8_t priority, bool completed, time_t dueDate) {
+        --totalCount;
+        if (priority <= kPriorities) --priorityCounts[priority];
+        if (completed) --completedCount;
+        else removePending(dueDate);
+    }
+
+    void TaskCounters::changePriority(uint8_t from, uint8_t to) {
+        if (from <= kPriorities) --priorityCounts[from];
+        if (to <= kPriorities) ++priorityCounts[to];
+    }
+
+    void TaskCounters::changeCompleted(bool completed, time_t dueDate) {
+        if (completed) {
+            ++completedCount;
+            removePending(dueDate);
+        }
+        else {
+            --completedCount;
+            addPending(dueDate);
+        }
+    }
+
+    void TaskCounters::changeDueDate(time_t from, time_t to) {
+        removePending(from);
+        addPending(to);
+    }
+
+    void TaskCounters::merge(const TaskCounters& other) {
+        totalCount += other.totalCount;
+        completedCount += other.completedCount;
+        for (size_t p = 0; p <= kPriorities; ++p) priorityCounts[p] += other.priorityCounts[p];
+        for (const auto& entry : other.pendingByDue) {
+            pendingByDue[entry.first] += entry.second;
+            if (entry.first < cursor) overdueCount += entry.second;
+        }
+    }
+
+    size_t TaskCounters::withPriority(uint8_t priority) const {
+        return priority <= kPriorities ? priorityCounts[priority] : 0;
+    }
+
+    size_t TaskCounters::overdue(time_t now) const {
+        overdueCount = overdueAt(now);
+        cursor = now;
+        return overdueCount;
+    }
+
+    size_t TaskCounters::overdueAt(time_t now) const {
+        size_t count = overdueCount;
+        if (now >= cursor) {
+            // Time moved forward: pick up the due dates in [cursor, now)
+            for (auto it = pendingByDue.lower_bound(cursor); it != pendingByDue.end() && it->first < now; ++it) {
+                count += it->second;
+            }
+        }
+        else {
+            // Clock went backwards: hand back the due dates in [now, cursor)
+            for (auto it = pendingByDue.lower_bound(now); it != pendingByDue.end() && it->first < cursor; ++it) {
+                count -= it->second;
+            }
+        }
+        return count;
+    }
+
+    void TaskCounters::addPending(time_t dueDate) {
+        // A due date of 0 means none, as in TaskDueQueue: never overdue
+        if (dueDate == 0) return;
+        ++pendingByDue[dueDate];
+        if (dueDate < cursor) ++overdueCount;
+    }
+
+    void TaskCounters::removePending(time_t dueDate) {
+        if (dueDate == 0) return;
+        auto it = pendingByDue.find(dueDate);
+        if (it == pendingByDue.end()) return;
+        if (--it->second == 0) pendingByDue.erase(it);
+        if (dueDate < cursor) --overdueCount;
+    }
+
+} // end namespace MyLibrary
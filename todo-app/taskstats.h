@@ -0,0 +1,77 @@
+#pragma once
+#ifndef TASKSTATS_H
+#define TASKSTATS_H
+
+#include <map>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <limits>
+
+namespace MyLibrary
+{
+    /**
+     * Point-in-time summary of the task list, as returned by Task::getStats.
+     */
+    struct TaskStats {
+        size_t total = 0;
+        size_t completed = 0;
+        size_t pending = 0;
+        size_t byPriority[5] = {};  // index 0 = HIGHEST ... 4 = LOWEST
+        size_t overdue = 0;         // pending and due before the query time (0 = no due date)
+
+        double completionPercentage() const {
+            return total == 0 ? 0.0 : (static_cast<double>(completed) / total) * 100.0;
+        }
+    };
+
+    /**
+     * Running counters kept up to date by every TaskStore mutation, so stats
+     * queries never rescan the columns.
+     *
+     * Overdue tracking keeps the number of pending tasks per due date and a
+     * cursor time: everything due before the cursor is already summed in
+     * overdueCount. A query moves the cursor to the requested time and only
+     * visits the due dates it passes over, so regular polling is O(1)
+     * amortised.
+     */
+    class TaskCounters {
+    public:
+        void clear();
+
+        void add(uint8_t priority, bool completed, time_t dueDate);
+        void remove(uint8_t priority, bool completed, time_t dueDate);
+        void changePriority(uint8_t from, uint8_t to);
+        void changeCompleted(bool completed, time_t dueDate);
+        // Only call for pending tasks; completed ones are never overdue
+        void changeDueDate(time_t from, time_t to);
+        // Add every task counted by other
+        void merge(const TaskCounters& other);
+
+        size_t total() const { return totalCount; }
+        size_t completed() const { return completedCount; }
+        size_t withPriority(uint8_t priority) const;
+        // Pending tasks with a due date before now; due date 0 means none
+        size_t overdue(time_t now) const;
+        // Same, without moving the cursor, so several threads may ask at once
+        size_t overdueAt(time_t now) const;
+
+    private:
+        static const size_t kPriorities = 5;
+
+        void addPending(time_t dueDate);
+        void removePending(time_t dueDate);
+
+        size_t totalCount = 0;
+        size_t completedCount = 0;
+        size_t priorityCounts[kPriorities + 1] = {};  // indexed by Priority value
+        std::map<time_t, size_t> pendingByDue;
+
+        // The cursor only moves inside const queries
+        mutable time_t cursor = std::numeric_limits<time_t>::min();
+        mutable size_t overdueCount = 0;  // pending tasks due before cursor
+    };
+
+} // end namespace MyLibrary
+
+#endif // TASKSTATS_H
@@ -0,0 +1,498 @@
+#include "taskstore.h"
+#include "threadpool.h"
+#include "taskmetrics.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+namespace MyLibrary
+{
+    /*--------------------- DESCRIPTION POOL ------------------------------*/
+
+    namespace
+    {
+        const size_t kArenaBlock = 1 << 20;
+        // Strings at least this long get a block of their own
+        const size_t kLargeText = kArenaBlock / 4;
+        // Never compact to reclaim less than this
+        const size_t kMinGarbage = 1 << 20;
+    }
+
+    DescriptionPool::DescriptionPool(const DescriptionPool& other) {
+        copyFrom(other);
+    }
+
+    DescriptionPool& DescriptionPool::operator=(const DescriptionPool& other) {
+        if (this != &other) copyFrom(other);
+        return *this;
+    }
+
+    void DescriptionPool::copyFrom(const DescriptionPool& other) {
+        entries = other.entries;
+        freeHandles = other.freeHandles;
+        blocks.clear();
+        cursor = nullptr;
+        remaining = 0;
+        live = other.live;
+        garbage = 0;
+        interning = other.interning;
+        lookup.clear();
+        char* out = live > 0 ? newBlock(live) : nullptr;
+        for (Entry& entry : entries) {
+            if (entry.size == 0) continue;
+            std::memcpy(out, entry.data, entry.size);
+            entry.data = out;
+            out += entry.size;
+        }
+        if (interning) {
+            lookup.reserve(entries.size());
+            for (size_t h = 0; h < entries.size(); ++h) {
+                if (entries[h].refs > 0) lookup.emplace(get(static_cast<Handle>(h)), static_cast<Handle>(h));
+            }
+        }
+    }
+
+    void DescriptionPool::clear() {
+        entries.clear();
+        freeHandles.clear();
+        blocks.clear();
+        cursor = nullptr;
+        remaining = 0;
+        live = 0;
+        garbage = 0;
+        lookup.clear();
+    }
+
+    void DescriptionPool::reserve(size_t count, size_t bytes) {
+        entries.reserve(count);
+        if (bytes > remaining) {
+            // One block for the whole batch
+            cursor = newBlock(bytes);
+            remaining = bytes;
+        }
+    }
+
+    char* DescriptionPool::newBlock(size_t bytes) {
+        TODO_COUNT(METRIC_ARENA_BLOCKS, 1);
+        TODO_COUNT(METRIC_ARENA_BYTES, bytes);
+        blocks.emplace_back(new char[bytes]);
+        return blocks.back().get();
+    }
+
+    char* DescriptionPool::store(std::string_view text) {
+        if (text.empty()) return nullptr;
+        char* out;
+        if (text.size() >= kLargeText) {
+            out = newBlock(text.size());
+        }
+        else {
+            if (text.size() > remaining) {
+                cursor = newBlock(kArenaBlock);
+                remaining = kArenaBlock;
+            }
+            out = cursor;
+            cursor += text.size();
+            remaining -= text.size();
+        }
+        std::memcpy(out, text.data(), text.size());
+        return out;
+    }
+
+    DescriptionPool::Handle DescriptionPool::add(std::string_view text) {
+        if (interning) {
+            auto it = lookup.find(text);
+            if (it != lookup.end()) {
+                ++entries[it->second].refs;
+                return it->second;
+            }
+        }
+
+        Entry entry{ store(text), static_cast<uint32_t>(text.size()), 1 };
+        live += text.size();
+        Handle handle;
+        if (!freeHandles.empty()) {
+            handle = freeHandles.back();
+            freeHandles.pop_back();
+            entries[handle] = entry;
+        }
+        else {
+            handle = static_cast<Handle>(entries.size());
+            entries.push_back(entry);
+        }
+        if (interning) lookup.emplace(get(handle), handle);
+        return handle;
+    }
+
+    DescriptionPool::Handle DescriptionPool::set(Handle handle, std::string_view text) {
+        if (interning) {
+            // Add before releasing: text may be the very bytes being released
+            Handle fresh = add(text);
+            release(handle);
+            return fresh;
+        }
+
+        Entry& entry = entries[handle];
+        live += text.size();
+        live -= entry.size;
+        if (text.size() <= entry.size) {
+            // Shrinking or same length: overwrite in place
+            if (!text.empty()) std::memmove(entry.data, text.data(), text.size());
+            garbage += entry.size - text.size();
+            entry.size = static_cast<uint32_t>(text.size());
+        }
+        else {
+            garbage += entry.size;
+            entry.data = store(text);
+            entry.size = static_cast<uint32_t>(text.size());
+        }
+        compactIfWasteful();
+        return handle;
+    }
+
+    void DescriptionPool::release(Handle handle) {
+        Entry& entry = entries[handle];
+        if (--entry.refs > 0) return;
+        if (interning) lookup.erase(get(handle));
+        live -= entry.size;
+        garbage += entry.size;
+        entry = Entry{ nullptr, 0, 0 };
+        freeHandles.push_back(handle);
+        compactIfWasteful();
+    }
+
+    DescriptionPool::Handle DescriptionPool::find(std::string_view text) const {
+        if (!interning) return npos;
+        auto it = lookup.find(text);
+        return it == lookup.end() ? npos : it->second;
+    }
+
+    void DescriptionPool::compactIfWasteful() {
+        if (garbage >= kMinGarbage && garbage > live) compact();
+    }
+
+    void DescriptionPool::compact() {
+        TODO_COUNT(METRIC_POOL_COMPACTIONS, 1);
+        DescriptionPool packed(*this);
+        *this = std::move(packed);
+    }
+
+    /*--------------------- TASK ROWS -------------------------------------*/
+
+    void TaskRows::reserve(size_t count) {
+        ids.reserve(count);
+        descriptions.reserve(count);
+        priorities.reserve(count);
+        completed.reserve(count);
+        dueDates.reserve(count);
+    }
+
+    void TaskRows::push(int id, std::string_view description, uint8_t priority, bool done, time_t dueDate) {
+        ids.push_back(id);
+        descriptions.push_back(description);
+        priorities.push_back(priority);
+        completed.push_back(done ? 1 : 0);
+        dueDates.push_back(dueDate);
+        counters.add(priority, done, dueDate);
+    }
+
+    /*--------------------- TASK STORE ------------------------------------*/
+
+    TaskColumnData& TaskStore::writableColumns() {
+        if (columnData.use_count() > 1) {
+            columnData = std::make_shared<TaskColumnData>(*columnData);
+        }
+        else {
+            // Seeing the count drop to one is not enough on its own: the
+            // fence orders the other owner's last reads before our writes
+            std::atomic_thread_fence(std::memory_order_acquire);
+        }
+        return *columnData;
+    }
+
+    void TaskStore::clear() {
+        // Snapshots keep the old columns; nothing needs copying
+        columnData = std::make_shared<TaskColumnData>();
+        idIndex.clear();
+        stats.clear();
+        orderIndex.reset();
+        textIndex.reset();
+        dueSchedule.reset();
+    }
+
+    void TaskStore::reserve(size_t count, size_t textBytes) {
+        TaskColumnData& data = writableColumns();
+        data.ids.reserve(count);
+        data.priorities.reserve(count);
+        data.completedBits.reserve((count + 63) / 64);
+        data.dueDates.reserve(count);
+        data.descriptions.reserve(count);
+        data.pool.reserve(count, textBytes);
+        idIndex.reserve(count);
+    }
+
+    size_t TaskStore::push(int id, std::string_view description, uint8_t priority, bool completed, time_t dueDate) {
+        TaskColumnData& data = writableColumns();
+        size_t slot = data.ids.size();
+        data.ids.push_back(id);
+        data.priorities.push_back(priority);
+        data.dueDates.push_back(dueDate);
+        data.descriptions.push_back(data.pool.add(description));
+        if ((slot & 63) == 0) data.completedBits.push_back(0);
+        if (completed) data.completedBits[slot >> 6] |= uint64_t(1) << (slot & 63);
+        idIndex.insert(id, slot);
+        stats.add(priority, completed, dueDate);
+        orderIndex.add(id, priority, dueDate);
+        textIndex.add(id, description);
+        if (!completed) dueSchedule.schedule(id, dueDate);
+        return slot;
+    }
+
+    void TaskStore::append(const TaskRows& rows, std::vector<size_t>* duplicates) {
+        TaskColumnData& data = writableColumns();
+        // Size the arena for the whole batch up front; interned batches mostly
+        // reuse text already in the pool
+        size_t bytes = 0;
+        if (!data.pool.interned()) {
+            for (std::string_view text : rows.descriptions) bytes += text.size();
+        }
+        data.pool.reserve(data.ids.size() + rows.size(), bytes);
+
+        std::vector<size_t> skipped;
+        for (size_t row = 0; row < rows.size(); ++row) {
+            size_t slot = data.ids.size();
+            int id = rows.ids[row];
+            if (!idIndex.tryInsert(id, slot)) {
+                skipped.push_back(row);
+                continue;
+            }
+            data.ids.push_back(id);
+            data.priorities.push_back(rows.priorities[row]);
+            data.dueDates.push_back(rows.dueDates[row]);
+            data.descriptions.push_back(data.pool.add(rows.descriptions[row]));
+            if ((slot & 63) == 0) data.completedBits.push_back(0);
+            if (rows.completed[row]) data.completedBits[slot >> 6] |= uint64_t(1) << (slot & 63);
+            orderIndex.add(id, rows.priorities[row], rows.dueDates[row]);
+            textIndex.add(id, rows.descriptions[row]);
+            if (!rows.completed[row]) dueSchedule.schedule(id, rows.dueDates[row]);
+        }
+
+        // The batch's counters were summed off-thread; back out what was skipped
+        stats.merge(rows.counters);
+        for (size_t row : skipped) {
+            stats.remove(rows.priorities[row], rows.completed[row] != 0, rows.dueDates[row]);
+        }
+        if (duplicates) duplicates->insert(duplicates->end(), skipped.begin(), skipped.end());
+    }
+
+    void TaskStore::erase(size_t slot) {
+        TaskColumnData& data = writableColumns();
+        stats.remove(data.priorities[slot], completed(slot), data.dueDates[slot]);
+        orderIndex.remove(data.ids[slot], data.priorities[slot], data.dueDates[slot]);
+        idIndex.erase(data.ids[slot]);
+        textIndex.remove(data.ids[slot], data.pool.get(data.descriptions[slot]));
+        dueSchedule.cancel(data.ids[slot]);
+        data.pool.release(data.descriptions[slot]);
+        data.ids.erase(data.ids.begin() + slot);
+        data.priorities.erase(data.priorities.begin() + slot);
+        data.dueDates.erase(data.dueDates.begin() + slot);
+        data.descriptions.erase(data.descriptions.begin() + slot);
+
+        // Shift the completed bits above slot down by one
+        size_t word = slot >> 6;
+        unsigned bit = static_cast<unsigned>(slot & 63);
+        uint64_t value = data.completedBits[word];
+        uint64_t below = value & ((uint64_t(1) << bit) - 1);
+        uint64_t above = bit == 63 ? 0 : (value >> (bit + 1)) << bit;
+        data.completedBits[word] = below | above;
+        for (size_t i = word + 1; i < data.completedBits.size(); ++i) {
+            data.completedBits[i - 1] |= (data.completedBits[i] & 1) << 63;
+            data.completedBits[i] >>= 1;
+        }
+        if ((data.ids.size() & 63) == 0) data.completedBits.pop_back();
+
+        // Everything after the erased slot moved down by one
+        for (size_t i = slot; i < data.ids.size(); ++i) {
+            idIndex.insert(data.ids[i], i);
+        }
+    }
+
+    void TaskStore::eraseSwapLast(size_t slot) {
+        TaskColumnData& data = writableColumns();
+        stats.remove(data.priorities[slot], completed(slot), data.dueDates[slot]);
+        orderIndex.remove(data.ids[slot], data.priorities[slot], data.dueDates[slot]);
+        idIndex.erase(data.ids[slot]);
+        textIndex.remove(data.ids[slot], data.pool.get(data.descriptions[slot]));
+        dueSchedule.cancel(data.ids[slot]);
+        data.pool.release(data.descriptions[slot]);
+
+        size_t last = data.ids.size() - 1;
+        if (slot != last) {
+            data.ids[slot] = data.ids[last];
+            data.priorities[slot] = data.priorities[last];
+            data.dueDates[slot] = data.dueDates[last];
+            data.descriptions[slot] = data.descriptions[last];
+            uint64_t mask = uint64_t(1) << (slot & 63);
+            if (completed(last)) data.completedBits[slot >> 6] |= mask;
+            else data.completedBits[slot >> 6] &= ~mask;
+            idIndex.insert(data.ids[slot], slot);
+        }
+        data.completedBits[last >> 6] &= ~(uint64_t(1) << (last & 63));
+        data.ids.pop_back();
+        data.priorities.pop_back();
+        data.dueDates.pop_back();
+        data.descriptions.pop_back();
+        if ((data.ids.size() & 63) == 0) data.completedBits.pop_back();
+    }
+
+    void TaskStore::eraseSlots(const std::vector<size_t>& sorted) {
+        TaskColumnData& data = writableColumns();
+        if (sorted.empty()) return;
+        for (size_t slot : sorted) {
+            stats.remove(data.priorities[slot], completed(slot), data.dueDates[slot]);
+            orderIndex.remove(data.ids[slot], data.priorities[slot], data.dueDates[slot]);
+            idIndex.erase(data.ids[slot]);
+            textIndex.remove(data.ids[slot], data.pool.get(data.descriptions[slot]));
+            dueSchedule.cancel(data.ids[slot]);
+            data.pool.release(data.descriptions[slot]);
+        }
+
+        // Slide the survivors down over the gaps, bits included
+        size_t out = sorted.front();
+        size_t next = 0;
+        for (size_t slot = out; slot < data.ids.size(); ++slot) {
+            if (next < sorted.size() && sorted[next] == slot) {
+                ++next;
+                continue;
+            }
+            data.ids[out] = data.ids[slot];
+            data.priorities[out] = data.priorities[slot];
+            data.dueDates[out] = data.dueDates[slot];
+            data.descriptions[out] = data.descriptions[slot];
+            uint64_t mask = uint64_t(1) << (out & 63);
+            if (completed(slot)) data.completedBits[out >> 6] |= mask;
+            else data.completedBits[out >> 6] &= ~mask;
+            idIndex.insert(data.ids[out], out);
+            ++out;
+        }
+        data.ids.resize(out);
+        data.priorities.resize(out);
+        data.dueDates.resize(out);
+        data.descriptions.resize(out);
+        data.completedBits.resize((out + 63) / 64);
+        if (out & 63) data.completedBits.back() &= (uint64_t(1) << (out & 63)) - 1;
+    }
+
+    void TaskStore::permute(const std::vector<size_t>& order) {
+        TaskColumnData& data = writableColumns();
+        size_t n = order.size();
+        std::vector<int> newIds(n);
+        std::vector<uint8_t> newPriorities(n);
+        std::vector<uint64_t> newCompleted(data.completedBits.size(), 0);
+        std::vector<time_t> newDueDates(n);
+        std::vector<DescriptionPool::Handle> newDescriptions(n);
+        // Chunks cover whole 64-slot words so no two threads share a completed word
+        size_t words = data.completedBits.size();
+        size_t chunks = splitWork(words, 1024);
+        parallelFor(chunks, [&](size_t chunk) {
+            size_t begin = chunkBegin(words, chunks, chunk) * 64;
+            size_t end = std::min(n, chunkBegin(words, chunks, chunk + 1) * 64);
+            for (size_t i = begin; i < end; ++i) {
+                size_t from = order[i];
+                newIds[i] = data.ids[from];
+                newPriorities[i] = data.priorities[from];
+                newDueDates[i] = data.dueDates[from];
+                newDescriptions[i] = data.descriptions[from];
+                if (completed(from)) newCompleted[i >> 6] |= uint64_t(1) << (i & 63);
+            }
+        });
+        data.ids.swap(newIds);
+        data.priorities.swap(newPriorities);
+        data.completedBits.swap(newCompleted);
+        data.dueDates.swap(newDueDates);
+        data.descriptions.swap(newDescriptions);
+
+        idIndex.clear();
+        idIndex.reserve(n);
+        for (size_t i = 0; i < n; ++i) {
+            idIndex.insert(data.ids[i], i);
+        }
+    }
+
+    void TaskStore::setDescription(size_t slot, std::string_view text) {
+        TaskColumnData& data = writableColumns();
+        if (textIndex.built()) {
+            textIndex.remove(data.ids[slot], data.pool.get(data.descriptions[slot]));
+            textIndex.add(data.ids[slot], text);
+        }
+        data.descriptions[slot] = data.pool.set(data.descriptions[slot], text);
+    }
+
+    void TaskStore::setPriority(size_t slot, uint8_t value) {
+        TaskColumnData& data = writableColumns();
+        stats.changePriority(data.priorities[slot], value);
+        orderIndex.changePriority(data.ids[slot], data.priorities[slot], value);
+        data.priorities[slot] = value;
+    }
+
+    void TaskStore::setCompleted(size_t slot, bool value) {
+        if (completed(slot) == value) return;
+        TaskColumnData& data = writableColumns();
+        stats.changeCompleted(value, data.dueDates[slot]);
+        data.completedBits[slot >> 6] ^= uint64_t(1) << (slot & 63);
+        // Reopening a task schedules its reminder again
+        if (value) dueSchedule.cancel(data.ids[slot]);
+        else dueSchedule.schedule(data.ids[slot], data.dueDates[slot]);
+    }
+
+    void TaskStore::setDueDate(size_t slot, time_t value) {
+        TaskColumnData& data = writableColumns();
+        if (!completed(slot)) stats.changeDueDate(data.dueDates[slot], value);
+        orderIndex.changeDueDate(data.ids[slot], data.dueDates[slot], value);
+        // Leave an already fired reminder alone unless the date moves
+        if (!completed(slot) && value != data.dueDates[slot]) dueSchedule.schedule(data.ids[slot], value);
+        data.dueDates[slot] = value;
+    }
+
+    void TaskStore::setInterning(bool on) {
+        if (on == interned()) return;
+        TaskColumnData& data = writableColumns();
+        // Re-add every description to a pool in the new mode
+        DescriptionPool rebuilt;
+        rebuilt.setInterning(on);
+        rebuilt.reserve(data.descriptions.size(), on ? 0 : data.pool.liveBytes());
+        for (DescriptionPool::Handle& handle : data.descriptions) {
+            handle = rebuilt.add(data.pool.get(handle));
+        }
+        data.pool = std::move(rebuilt);
+    }
+
+    const TaskOrderIndex& TaskStore::sortedIndex() {
+        const TaskColumnData& data = *columnData;
+        if (!orderIndex.built()) orderIndex.build(data.ids, data.priorities, data.dueDates);
+        return orderIndex;
+    }
+
+    TaskColumns TaskStore::columns() const {
+        TaskColumns snapshot;
+        snapshot.data = columnData;
+        return snapshot;
+    }
+
+    const TaskTextIndex& TaskStore::searchIndex() {
+        const TaskColumnData& data = *columnData;
+        if (!textIndex.built()) {
+            std::vector<std::string_view> texts(data.descriptions.size());
+            for (size_t slot = 0; slot < texts.size(); ++slot) texts[slot] = data.pool.get(data.descriptions[slot]);
+            textIndex.build(data.ids, texts);
+        }
+        return textIndex;
+    }
+
+    TaskDueQueue& TaskStore::dueQueue() {
+        const TaskColumnData& data = *columnData;
+        if (!dueSchedule.built()) dueSchedule.build(data.ids, data.completedBits, data.dueDates);
+        return dueSchedule;
+    }
+
+} // end namespace MyLibrary
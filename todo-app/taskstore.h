@@ -0,0 +1,238 @@
+#pragma once
+#ifndef TASKSTORE_H
+#define TASKSTORE_H
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <memory>
+#include <unordered_map>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+
+#include "taskindex.h"
+#include "taskstats.h"
+#include "taskorder.h"
+#include "tasksearch.h"
+#include "taskschedule.h"
+
+namespace MyLibrary
+{
+    /**
+     * Owns the text of every task description. Tasks refer to their text by
+     * a small integer handle, so the hot columns never hold a std::string.
+     *
+     * The bytes live in an append-only arena of large blocks: adding a
+     * description is a copy into the current block, not a heap allocation.
+     * Text replaced or released stays in the arena as garbage until it
+     * outweighs the live text, at which point the pool compacts itself.
+     * Views returned by get() are valid until the next set/release/compact.
+     *
+     * With interning on, equal descriptions share one reference-counted
+     * handle, so each distinct text is stored once and two descriptions are
+     * equal exactly when their handles are.
+     */
+    class DescriptionPool {
+    public:
+        using Handle = uint32_t;
+        static constexpr Handle npos = UINT32_MAX;
+
+        DescriptionPool() = default;
+        // Copies are compacted into a single block
+        DescriptionPool(const DescriptionPool& other);
+        DescriptionPool(DescriptionPool&&) = default;
+        DescriptionPool& operator=(const DescriptionPool& other);
+        DescriptionPool& operator=(DescriptionPool&&) = default;
+
+        void clear();
+        // Room for count descriptions in all, plus bytes more characters
+        void reserve(size_t count, size_t bytes = 0);
+
+        // Only switch on an empty pool; TaskStore::setInterning re-adds
+        // existing descriptions for you
+        void setInterning(bool on) { interning = on; }
+        bool interned() const { return interning; }
+
+        Handle add(std::string_view text);
+        // Replace the text behind handle; returns the handle to keep using,
+        // which differs from the old one when interning
+        Handle set(Handle handle, std::string_view text);
+        void release(Handle handle);
+        // Handle of an interned text, or npos (always npos when not interning)
+        Handle find(std::string_view text) const;
+        std::string_view get(Handle handle) const {
+            return std::string_view(entries[handle].data, entries[handle].size);
+        }
+
+        // Move the live text into fresh blocks, dropping the garbage
+        void compact();
+        size_t liveBytes() const { return live; }
+        size_t garbageBytes() const { return garbage; }
+
+    private:
+        struct Entry {
+            char* data;
+            uint32_t size;
+            uint32_t refs;  // tasks using this entry; 0 = free
+        };
+
+        char* store(std::string_view text);
+        char* newBlock(size_t bytes);
+        void copyFrom(const DescriptionPool& other);
+        void compactIfWasteful();
+
+        std::vector<Entry> entries;
+        std::vector<Handle> freeHandles;
+        std::vector<std::unique_ptr<char[]>> blocks;
+        char* cursor = nullptr;   // free space in the newest block
+        size_t remaining = 0;
+        size_t live = 0;
+        size_t garbage = 0;
+        bool interning = false;
+        std::unordered_map<std::string_view, Handle> lookup;  // interned texts
+    };
+
+    /**
+     * A batch of rows built away from the store (e.g. by a loader thread)
+     * and added to it in one TaskStore::append call.
+     */
+    struct TaskRows {
+        std::vector<int> ids;
+        // Views into storage the caller keeps alive until append()
+        std::vector<std::string_view> descriptions;
+        std::vector<uint8_t> priorities;
+        std::vector<uint8_t> completed;  // 0 or 1
+        std::vector<time_t> dueDates;
+        TaskCounters counters;  // stats of the rows above
+
+        size_t size() const { return ids.size(); }
+        void reserve(size_t count);
+        void push(int id, std::string_view description, uint8_t priority, bool done, time_t dueDate);
+    };
+
+    // The rows of a TaskStore, one vector per field
+    struct TaskColumnData {
+        std::vector<int> ids;
+        std::vector<uint8_t> priorities;
+        std::vector<uint64_t> completedBits;
+        std::vector<time_t> dueDates;
+        std::vector<DescriptionPool::Handle> descriptions;
+        DescriptionPool pool;
+    };
+
+    /**
+     * Read-only snapshot of a store's rows without its indexes or counters,
+     * which is all a background save or snapshot needs. Taking one costs a
+     * reference count: the store and its snapshots share the columns, and
+     * the store copies them before its next write while a snapshot is
+     * still alive (so that write is O(n) instead).
+     */
+    class TaskColumns {
+    public:
+        size_t size() const { return data->ids.size(); }
+
+        int id(size_t slot) const { return data->ids[slot]; }
+        std::string_view description(size_t slot) const { return data->pool.get(data->descriptions[slot]); }
+        uint8_t priority(size_t slot) const { return data->priorities[slot]; }
+        bool completed(size_t slot) const { return (data->completedBits[slot >> 6] >> (slot & 63)) & 1; }
+        time_t dueDate(size_t slot) const { return data->dueDates[slot]; }
+
+        bool interned() const { return data->pool.interned(); }
+        const std::vector<DescriptionPool::Handle>& descriptionColumn() const { return data->descriptions; }
+
+    private:
+        friend class TaskStore;
+
+        std::shared_ptr<const TaskColumnData> data;
+    };
+
+    /**
+     * Column-oriented task storage: one contiguous array per field, indexed
+     * by slot. Scans that only need one field (completion, due date,
+     * priority) walk just that column. Also keeps the ID -> slot index, the
+     * running TaskCounters, the sorted TaskOrderIndex and the TaskDueQueue,
+     * all updated by every mutation below.
+     */
+    class TaskStore {
+    public:
+        size_t size() const { return columnData->ids.size(); }
+        bool empty() const { return columnData->ids.empty(); }
+
+        void clear();
+        // Room for count tasks whose descriptions total textBytes
+        void reserve(size_t count, size_t textBytes = 0);
+
+        // Append a task and return its slot. The caller guarantees the ID is unused.
+        size_t push(int id, std::string_view description, uint8_t priority, bool completed, time_t dueDate);
+        // Append a batch in order. Rows whose ID is already in the store are
+        // skipped and, if duplicates is given, their row numbers appended to it.
+        void append(const TaskRows& rows, std::vector<size_t>* duplicates = nullptr);
+        // Remove the task in slot; later slots move down by one.
+        void erase(size_t slot);
+        // Remove the task in slot by moving the last task into it. O(1), but
+        // changes the order.
+        void eraseSwapLast(size_t slot);
+        // Remove every slot in sorted (ascending, distinct) in one pass,
+        // keeping the order of the rest.
+        void eraseSlots(const std::vector<size_t>& sorted);
+        // Reorder so that new slot i holds what was in slot order[i].
+        void permute(const std::vector<size_t>& order);
+
+        // TaskIndex::npos if no task has that ID
+        size_t find(int id) const { return idIndex.find(id); }
+
+        int id(size_t slot) const { return columnData->ids[slot]; }
+        std::string_view description(size_t slot) const { return columnData->pool.get(columnData->descriptions[slot]); }
+        uint8_t priority(size_t slot) const { return columnData->priorities[slot]; }
+        bool completed(size_t slot) const { return (columnData->completedBits[slot >> 6] >> (slot & 63)) & 1; }
+        time_t dueDate(size_t slot) const { return columnData->dueDates[slot]; }
+
+        void setDescription(size_t slot, std::string_view text);
+        void setPriority(size_t slot, uint8_t value);
+        void setCompleted(size_t slot, bool value);
+        void setDueDate(size_t slot, time_t value);
+
+        // Share one copy of each distinct description (see DescriptionPool)
+        void setInterning(bool on);
+        bool interned() const { return columnData->pool.interned(); }
+        const DescriptionPool& descriptionPool() const { return columnData->pool; }
+
+        // Raw columns for bulk scans; like views, valid until the next write
+        const std::vector<int>& idColumn() const { return columnData->ids; }
+        // Pool handles; with interning, equal handles mean equal text
+        const std::vector<DescriptionPool::Handle>& descriptionColumn() const { return columnData->descriptions; }
+        const std::vector<uint8_t>& priorityColumn() const { return columnData->priorities; }
+        const std::vector<time_t>& dueDateColumn() const { return columnData->dueDates; }
+        // One bit per slot, 64 slots per word; bits past size() are zero
+        const std::vector<uint64_t>& completedColumn() const { return columnData->completedBits; }
+
+        // Snapshot of the rows for readers that need no lookups; O(1)
+        TaskColumns columns() const;
+
+        size_t countCompleted() const { return stats.completed(); }
+        const TaskCounters& counters() const { return stats; }
+        // Builds the sorted indexes on first use
+        const TaskOrderIndex& sortedIndex();
+        // Builds the description search index on first use
+        const TaskTextIndex& searchIndex();
+        // Builds the due-date queue on first use. Popping from it is how
+        // callers mark a task as reminded; see TaskList::fireReminders
+        TaskDueQueue& dueQueue();
+
+    private:
+        // The columns, copied first if a TaskColumns snapshot shares them
+        TaskColumnData& writableColumns();
+
+        // Shared with TaskColumns snapshots (and copies of the store) until written
+        std::shared_ptr<TaskColumnData> columnData = std::make_shared<TaskColumnData>();
+        TaskIndex idIndex;
+        TaskCounters stats;
+        TaskOrderIndex orderIndex;
+        TaskTextIndex textIndex;
+        TaskDueQueue dueSchedule;
+    };
+
+} // end namespace MyLibrary
+
+#endif // TASKSTORE_H
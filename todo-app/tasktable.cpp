@@ -0,0 +1,80 @@
+#include "tasktable.h"
+
+#include <charconv>
+
+namespace MyLibrary
+{
+    namespace
+    {
+        const size_t kWriteThreshold = 256 * 1024;
+
+        // priorityToString without building a std::string per row
+        std::string_view priorityName(uint8_t priority) {
+            static const std::string_view names[] = {
+                "Unknown", "Highest", "High", "Medium", "Low", "Lowest"
+            };
+            return priority <= 5 ? names[priority] : names[0];
+        }
+    }
+
+    TaskTable::TaskTable(std::ostream& out)
+        : out(out)
+    {
+    }
+
+    void TaskTable::begin(size_t rows) {
+        total = rows;
+        seen = 0;
+        printed = 0;
+        buffer.clear();
+        field("ID", 5);
+        field("Description", 25);
+        field("Priority", 10);
+        field("Status", 10);
+        field("Due Date", 20);
+        buffer += '\n';
+    }
+
+    bool TaskTable::row(const TaskStore& store, size_t slot) {
+        if (limit != 0 && printed == limit) return false;
+        if (seen++ < offset) return true;
+
+        char id[16];
+        char* idEnd = std::to_chars(id, id + sizeof(id), store.id(slot)).ptr;
+        field(std::string_view(id, idEnd - id), 5);
+        field(store.description(slot), 25);
+        field(priorityName(store.priority(slot)), 10);
+        field(store.completed(slot) ? "Completed" : "Pending", 10);
+        field(dates.format(store.dueDate(slot)), 20);
+        buffer += '\n';
+        ++printed;
+
+        if (buffer.size() >= kWriteThreshold) write();
+        return true;
+    }
+
+    void TaskTable::end() {
+        size_t shown = offset + printed;
+        if (shown < total) {
+            buffer += "... ";
+            char count[24];
+            buffer.append(count, std::to_chars(count, count + sizeof(count), total - shown).ptr);
+            buffer += " more tasks not shown.\n";
+        }
+        write();
+        out.flush();
+        offset = 0;
+    }
+
+    void TaskTable::field(std::string_view text, size_t width) {
+        // Left-aligned and padded, never truncated (as std::setw)
+        buffer += text;
+        if (text.size() < width) buffer.append(width - text.size(), ' ');
+    }
+
+    void TaskTable::write() {
+        out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        buffer.clear();
+    }
+
+} // end namespace MyLibrary
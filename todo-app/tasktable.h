@@ -0,0 +1,62 @@
+#pragma once
+#ifndef TASKTABLE_H
+#define TASKTABLE_H
+
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <limits>
+#include <cstddef>
+#include <ctime>
+
+#include "taskstore.h"
+#include "taskdate.h"
+
+namespace MyLibrary
+{
+    /**
+     * Formats task listings into one reusable buffer and hands it to the
+     * stream in large writes, with a single flush per listing. Fields are
+     * padded exactly like the old std::setw output.
+     *
+     * A listing is begin(total), row() per task until it returns false,
+     * then end(). Rows before the offset are skipped and at most limit rows
+     * are printed; end() says how many were left out.
+     */
+    class TaskTable {
+    public:
+        explicit TaskTable(std::ostream& out);
+
+        // Rows to skip at the start of the next listing
+        void setOffset(size_t rows) { offset = rows; }
+        // Most rows per listing; 0 = no limit
+        void setLimit(size_t rows) { limit = rows; }
+        size_t getLimit() const { return limit; }
+
+        // Start a listing of total rows (used for the "more" footer)
+        void begin(size_t total);
+        // Append one row; false once the limit is reached
+        bool row(const TaskStore& store, size_t slot);
+        // Write out what is left and flush the stream
+        void end();
+
+    private:
+        TaskTable(const TaskTable&) = delete;
+        TaskTable& operator=(const TaskTable&) = delete;
+
+        void field(std::string_view text, size_t width);
+        void write();
+
+        std::ostream& out;
+        std::string buffer;
+        DateFormatter dates;
+        size_t offset = 0;
+        size_t limit = 0;
+        size_t total = 0;
+        size_t seen = 0;     // rows offered in this listing
+        size_t printed = 0;  // rows actually written
+    };
+
+} // end namespace MyLibrary
+
+#endif // TASKTABLE_H
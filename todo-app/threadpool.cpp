@@ -0,0 +1,174 @@
+#include "threadpool.h"
+
+#include <atomic>
+#include <cstdint>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace MyLibrary
+{
+    namespace
+    {
+        // Set while the current thread is running a chunk, so nested
+        // parallelFor calls do not wait on the pool they are part of
+        thread_local bool insideJob = false;
+
+        class ThreadPool {
+        public:
+            ~ThreadPool() { stopWorkers(); }
+
+            void resize(size_t threads) {
+                std::lock_guard<std::mutex> running(runMutex);
+                stopWorkers();
+                threadCount = threads;
+            }
+
+            size_t size() const {
+                size_t threads = threadCount;
+                if (threads == 0) {
+                    threads = std::thread::hardware_concurrency();
+                    if (threads == 0) threads = 1;
+                }
+                return threads;
+            }
+
+            void run(size_t chunks, const std::function<void(size_t)>& body) {
+                std::unique_lock<std::mutex> running(runMutex, std::try_to_lock);
+                if (!running.owns_lock() || insideJob || chunks < 2 || size() < 2) {
+                    runSerial(chunks, body);
+                    return;
+                }
+                startWorkers();
+
+                // Deal the chunks out in contiguous shares, one per participant
+                participants = workers.size() + 1;
+                for (size_t p = 0; p < participants; ++p) {
+                    shares[p].next.store(chunkBegin(chunks, participants, p), std::memory_order_relaxed);
+                    shares[p].end = chunkBegin(chunks, participants, p + 1);
+                }
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    job = &body;
+                    finished = 0;
+                    ++generation;
+                }
+                wake.notify_all();
+
+                work(0);
+
+                std::unique_lock<std::mutex> lock(mutex);
+                done.wait(lock, [this] { return finished == workers.size(); });
+                job = nullptr;
+            }
+
+        private:
+            struct Share {
+                std::atomic<size_t> next{ 0 };
+                size_t end = 0;
+            };
+
+            static void runSerial(size_t chunks, const std::function<void(size_t)>& body) {
+                bool outer = insideJob;
+                insideJob = true;
+                for (size_t c = 0; c < chunks; ++c) body(c);
+                insideJob = outer;
+            }
+
+            void startWorkers() {
+                size_t count = size() - 1;
+                if (workers.size() == count) return;
+                shares.reset(new Share[count + 1]);
+                stopping = false;
+                // New workers must only pick up jobs posted after they start
+                uint64_t current = generation;
+                for (size_t i = 0; i < count; ++i) {
+                    workers.emplace_back([this, i, current] { workerLoop(i + 1, current); });
+                }
+            }
+
+            void stopWorkers() {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    stopping = true;
+                }
+                wake.notify_all();
+                for (std::thread& worker : workers) worker.join();
+                workers.clear();
+            }
+
+            void workerLoop(size_t self, uint64_t seen) {
+                for (;;) {
+                    {
+                        std::unique_lock<std::mutex> lock(mutex);
+                        wake.wait(lock, [&] { return stopping || generation != seen; });
+                        if (stopping) return;
+                        seen = generation;
+                    }
+                    work(self);
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        ++finished;
+                    }
+                    done.notify_one();
+                }
+            }
+
+            // Drain our own share, then steal from everyone else's
+            void work(size_t self) {
+                insideJob = true;
+                for (size_t k = 0; k < participants; ++k) {
+                    Share& share = shares[(self + k) % participants];
+                    for (;;) {
+                        size_t chunk = share.next.fetch_add(1, std::memory_order_relaxed);
+                        if (chunk >= share.end) break;
+                        (*job)(chunk);
+                    }
+                }
+                insideJob = false;
+            }
+
+            std::mutex runMutex;  // one parallelFor at a time
+            std::mutex mutex;     // guards the fields below
+            std::condition_variable wake;
+            std::condition_variable done;
+            std::vector<std::thread> workers;
+            std::unique_ptr<Share[]> shares;
+            const std::function<void(size_t)>* job = nullptr;
+            uint64_t generation = 0;
+            size_t participants = 0;  // workers plus the calling thread
+            size_t finished = 0;
+            size_t threadCount = 0;
+            bool stopping = false;
+        };
+
+        ThreadPool& pool() {
+            static ThreadPool instance;
+            return instance;
+        }
+    }
+
+    void setParallelism(size_t threads) {
+        pool().resize(threads);
+    }
+
+    size_t parallelism() {
+        return pool().size();
+    }
+
+    size_t splitWork(size_t items, size_t minPerChunk) {
+        size_t threads = parallelism();
+        if (threads < 2 || minPerChunk == 0) return 1;
+        size_t chunks = items / minPerChunk;
+        size_t most = threads * 4;
+        if (chunks > most) chunks = most;
+        return chunks == 0 ? 1 : chunks;
+    }
+
+    void parallelFor(size_t chunks, const std::function<void(size_t)>& body) {
+        pool().run(chunks, body);
+    }
+
+} // end namespace MyLibrary
@@ -0,0 +1,43 @@
+#pragma once
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <cstddef>
+#include <functional>
+
+// The parallel standard algorithms are used where the library ships a real
+// backend: MSVC always does; define TODO_PARALLEL_STL elsewhere when
+// building against libstdc++ with TBB.
+#if !defined(TODO_PARALLEL_STL) && defined(_MSC_VER) && _MSVC_LANG >= 201703L
+#define TODO_PARALLEL_STL 1
+#endif
+
+namespace MyLibrary
+{
+    /*
+     * Shared worker pool for the bulk task operations (sorting, filtering,
+     * serialisation). Work is split into chunks; each thread starts on its
+     * own share of the chunks and steals from the others once that runs out.
+     */
+
+    // 0 = one thread per hardware thread, 1 = run everything on the caller
+    void setParallelism(size_t threads);
+    size_t parallelism();
+
+    // How many chunks to split items into so each has at least minPerChunk
+    // items and every thread gets a few to balance with. Never returns 0.
+    size_t splitWork(size_t items, size_t minPerChunk);
+
+    // Run body(chunk) for every chunk in [0, chunks) and wait for all of
+    // them. Calls from inside a body, or while another thread has the pool,
+    // run on the calling thread.
+    void parallelFor(size_t chunks, const std::function<void(size_t)>& body);
+
+    // First item of chunk when items are split evenly into chunks pieces
+    inline size_t chunkBegin(size_t items, size_t chunks, size_t chunk) {
+        return items / chunks * chunk + (chunk < items % chunks ? chunk : items % chunks);
+    }
+
+} // end namespace MyLibrary
+
+#endif // THREADPOOL_H
@@ -0,0 +1,315 @@
+#include "mylibrary.h"
+#include "datagen.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <streambuf>
+
+using namespace MyLibrary;
+
+namespace
+{
+    // Listings are rendered in full but thrown away, so display benchmarks
+    // time the formatting rather than the terminal
+    class DiscardBuffer : public std::streambuf {
+    protected:
+        int overflow(int c) override { return c == traits_type::eof() ? 0 : c; }
+        std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+    };
+
+    struct Benchmark {
+        std::string name;
+        size_t items;                 // operations in one run, for rates
+        std::function<void()> setup;  // untimed, before every run
+        std::function<void()> run;
+    };
+
+    struct Result {
+        std::string name;
+        size_t items = 0;
+        std::vector<double> seconds;  // one per timed run, sorted
+
+        double median() const { return seconds[seconds.size() / 2]; }
+        double mean() const {
+            double total = 0;
+            for (double s : seconds) total += s;
+            return total / seconds.size();
+        }
+    };
+
+    /**
+     * Everything the benchmarks share: the generated files, one list that
+     * is reloaded from the snapshot whenever a benchmark changed it, and
+     * a fixed set of IDs to look up.
+     */
+    class Fixture {
+    public:
+        Fixture(const std::filesystem::path& dir, const DatasetOptions& options)
+            : options(options), output(&discard)
+        {
+            textFile = (dir / "bench-tasks.txt").string();
+            snapshotFile = (dir / "bench-tasks.snap").string();
+            compressedFile = (dir / "bench-tasks-lz.snap").string();
+            outFile = (dir / "bench-out.txt").string();
+            outSnapshot = (dir / "bench-out.snap").string();
+        }
+
+        bool prepare() {
+            if (!writeDataset(textFile, options)) return false;
+            reload(textFile);
+            list->saveTasksToSnapshot(snapshotFile);
+            list->setSnapshotCompression(true);
+            list->saveTasksToSnapshot(compressedFile);
+            list->setSnapshotCompression(false);
+
+            // A shuffled sample of the IDs, the same for every run
+            std::vector<int> all(options.tasks);
+            for (size_t i = 0; i < all.size(); ++i) all[i] = static_cast<int>(i + 1);
+            DatasetGenerator shuffle(options);
+            for (size_t i = all.size(); i-- > 1;) std::swap(all[i], all[shuffle.random() % (i + 1)]);
+            all.resize(std::min<size_t>(all.size(), 100000));
+            ids = std::move(all);
+            return true;
+        }
+
+        void reload(const std::string& file) {
+            list = std::make_unique<TaskList>();
+            list->setOutput(output);
+            list->loadTasksFromFile(file);
+            dirty = false;
+        }
+
+        // Undo whatever the last benchmark changed
+        void fresh() {
+            if (dirty) reload(snapshotFile);
+        }
+
+        void cleanup() {
+            std::error_code ec;
+            for (const std::string& file : { textFile, snapshotFile, compressedFile, outFile, outSnapshot }) {
+                std::filesystem::remove(file, ec);
+            }
+        }
+
+        DatasetOptions options;
+        std::string textFile, snapshotFile, compressedFile, outFile, outSnapshot;
+        std::unique_ptr<TaskList> list;
+        std::vector<int> ids;
+        bool dirty = true;
+
+    private:
+        DiscardBuffer discard;
+        std::ostream output;
+    };
+
+    std::vector<Benchmark> makeBenchmarks(Fixture& f) {
+        size_t n = f.options.tasks;
+        size_t picks = f.ids.size();
+        time_t now = std::time(nullptr);
+        auto none = [] {};
+        auto fresh = [&f] { f.fresh(); };
+        // Benchmarks that change the list mark it for the next fresh()
+        auto changes = [&f](std::function<void()> body) {
+            return [&f, body] { body(); f.dirty = true; };
+        };
+        TaskFilter urgent;
+        urgent.completed = false;
+        urgent.maxPriority = HIGH;
+        urgent.dueBefore = now;
+
+        std::vector<Benchmark> list = {
+            { "generate", n, none, [&f] { writeDataset(f.outFile, f.options); } },
+            { "load_text", n, none, [&f] { f.reload(f.textFile); } },
+            { "load_snapshot", n, none, [&f] { f.reload(f.snapshotFile); } },
+            { "load_snapshot_compressed", n, none, [&f] { f.reload(f.compressedFile); } },
+            { "save_text", n, fresh, [&f] { f.list->saveTasksToFile(f.outFile); } },
+            { "save_snapshot", n, fresh, [&f] { f.list->saveTasksToSnapshot(f.outSnapshot); } },
+            { "save_snapshot_compressed", n, fresh, [&f] {
+                f.list->setSnapshotCompression(true);
+                f.list->saveTasksToSnapshot(f.outSnapshot);
+                f.list->setSnapshotCompression(false);
+            } },
+            { "add", picks, fresh, changes([&f, picks] {
+                for (size_t i = 0; i < picks; ++i) f.list->emplaceTask("Benchmark task", MEDIUM, 0);
+            }) },
+            { "find_by_id", picks, fresh, [&f] {
+                size_t found = 0;
+                for (int id : f.ids) found += f.list->find(id).has_value();
+                if (found != f.ids.size()) std::cerr << "Warning: lookups missed.\n";
+            } },
+            { "update_by_id", picks, fresh, changes([&f] {
+                int i = 0;
+                for (int id : f.ids) f.list->updateTask(id, {}, static_cast<Priority>(HIGHEST + i++ % 5));
+            }) },
+            { "apply_batch", picks, fresh, changes([&f] {
+                std::vector<Mutation> batch(f.ids.size());
+                for (size_t i = 0; i < batch.size(); ++i) {
+                    batch[i].op = i % 2 ? MUTATION_COMPLETE : MUTATION_UPDATE;
+                    batch[i].id = f.ids[i];
+                    if (!(i % 2)) batch[i].dueDate = static_cast<time_t>(1700000000 + i);
+                }
+                f.list->applyBatch(batch);
+            }) },
+            { "delete_by_id_swap", picks, fresh, changes([&f] {
+                f.list->setDeleteMode(DELETE_SWAP);
+                for (int id : f.ids) f.list->deleteTask(id);
+                f.list->setDeleteMode(DELETE_SHIFT);
+            }) },
+            // Every shift delete moves the rest of the list, so only a few
+            { "delete_by_id_shift", std::min<size_t>(picks, 100), fresh, changes([&f] {
+                for (size_t i = 0; i < f.ids.size() && i < 100; ++i) f.list->deleteTask(f.ids[i]);
+            }) },
+            { "sort_by_priority", n, fresh, changes([&f] { f.list->sortTasksByPriority(); }) },
+            { "sort_by_due_date", n, fresh, changes([&f] { f.list->sortTasksByDueDate(); }) },
+            { "sort_by_priority_then_due", n, fresh, changes([&f] { f.list->sortTasksByPriorityThenDueDate(); }) },
+            { "filter_count", n, fresh, [&f, urgent] { f.list->countMatching(urgent); } },
+            { "filter_display", n, fresh, [&f, urgent] { f.list->filterTasks(urgent); } },
+            { "query_due_top100", n, fresh, [&f] {
+                f.list->query().pending().orderBy(ORDER_DUE_DATE).limit(100).slots();
+            } },
+            { "search", n, fresh, [&f] { f.list->searchTasks("report"); } },
+            { "stats", 1000, fresh, [&f, now] {
+                for (int i = 0; i < 1000; ++i) f.list->getStats(now + i);
+            } },
+            { "display_all", n, fresh, [&f] { f.list->displayTasks(); } },
+            { "display_by_due_date", n, fresh, [&f] { f.list->displayTasksByDueDate(); } },
+            { "reminders", n, fresh, changes([&f, now] { f.list->fireReminders(now, [](const Task&) {}); }) },
+        };
+        return list;
+    }
+
+    Result measure(const Benchmark& bench, double minSeconds, size_t minRuns) {
+        Result result;
+        result.name = bench.name;
+        result.items = bench.items;
+        // One untimed run warms caches and builds lazy indexes
+        bench.setup();
+        bench.run();
+        double total = 0;
+        while (result.seconds.size() < minRuns || (total < minSeconds && result.seconds.size() < 100)) {
+            bench.setup();
+            auto start = std::chrono::steady_clock::now();
+            bench.run();
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            result.seconds.push_back(seconds);
+            total += seconds;
+        }
+        std::sort(result.seconds.begin(), result.seconds.end());
+        return result;
+    }
+
+    bool writeJson(const std::string& path, const std::string& label, const DatasetOptions& options,
+        const std::vector<Result>& results)
+    {
+        std::ofstream out(path);
+        if (!out) {
+            std::cerr << "Error: Unable to open " << path << " for writing.\n";
+            return false;
+        }
+        out << "{\n"
+            << "  \"format\": 1,\n"
+            << "  \"label\": \"" << label << "\",\n"
+            << "  \"timestamp\": " << static_cast<long long>(std::time(nullptr)) << ",\n"
+#ifdef NDEBUG
+            << "  \"build\": \"release\",\n"
+#else
+            << "  \"build\": \"debug\",\n"
+#endif
+            << "  \"tasks\": " << options.tasks << ",\n"
+            << "  \"seed\": " << options.seed << ",\n"
+            << "  \"threads\": " << parallelism() << ",\n"
+            << "  \"results\": [\n";
+        out << std::setprecision(9);
+        for (size_t i = 0; i < results.size(); ++i) {
+            const Result& r = results[i];
+            out << "    { \"name\": \"" << r.name << "\", \"items\": " << r.items
+                << ", \"runs\": " << r.seconds.size()
+                << ", \"min_seconds\": " << r.seconds.front()
+                << ", \"median_seconds\": " << r.median()
+                << ", \"mean_seconds\": " << r.mean()
+                << ", \"items_per_second\": " << r.items / r.median() << " }"
+                << (i + 1 < results.size() ? ",\n" : "\n");
+        }
+        out << "  ]\n}\n";
+        return static_cast<bool>(out);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    // --generate=N: only write a dataset of N tasks to --out (default tasks.txt)
+    // --tasks=N: dataset size for the benchmarks (default 1000000)
+    // --seed=S: dataset seed (default 1)
+    // --filter=TEXT: run only benchmarks whose name contains TEXT
+    // --min-time=MS: keep repeating each benchmark for at least MS (default 500)
+    // --runs=N: and at least N timed runs (default 3)
+    // --threads=N: worker threads (0 = all cores)
+    // --json=FILE: also write the results as JSON, labelled with --label=TEXT
+    // --dir=PATH: where the benchmark files go (default the temp directory)
+    DatasetOptions options;
+    size_t generate = 0;
+    std::string out = "tasks.txt";
+    std::string filter, json, label;
+    double minSeconds = 0.5;
+    size_t minRuns = 3;
+    std::filesystem::path dir = std::filesystem::temp_directory_path();
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value = [&](const char* option) { return arg.substr(std::strlen(option)); };
+        auto number = [&](const char* option) {
+            return static_cast<size_t>(std::strtoull(arg.c_str() + std::strlen(option), nullptr, 10));
+        };
+        if (arg.rfind("--generate=", 0) == 0) generate = number("--generate=");
+        else if (arg.rfind("--out=", 0) == 0) out = value("--out=");
+        else if (arg.rfind("--tasks=", 0) == 0) options.tasks = number("--tasks=");
+        else if (arg.rfind("--seed=", 0) == 0) options.seed = number("--seed=");
+        else if (arg.rfind("--filter=", 0) == 0) filter = value("--filter=");
+        else if (arg.rfind("--min-time=", 0) == 0) minSeconds = number("--min-time=") / 1000.0;
+        else if (arg.rfind("--runs=", 0) == 0) minRuns = std::max<size_t>(1, number("--runs="));
+        else if (arg.rfind("--threads=", 0) == 0) TaskList::setParallelism(number("--threads="));
+        else if (arg.rfind("--json=", 0) == 0) json = value("--json=");
+        else if (arg.rfind("--label=", 0) == 0) label = value("--label=");
+        else if (arg.rfind("--dir=", 0) == 0) dir = value("--dir=");
+        else {
+            std::cerr << "Error: Unknown option " << arg << ".\n";
+            return 1;
+        }
+    }
+
+    if (generate > 0) {
+        options.tasks = generate;
+        if (!writeDataset(out, options)) return 1;
+        std::cout << "Wrote " << generate << " tasks to " << out << ".\n";
+        return 0;
+    }
+    if (options.tasks == 0) {
+        std::cerr << "Error: --tasks must be at least 1.\n";
+        return 1;
+    }
+
+    Fixture fixture(dir, options);
+    std::cout << "Generating " << options.tasks << " tasks..." << std::endl;
+    if (!fixture.prepare()) return 1;
+
+    std::vector<Result> results;
+    std::cout << std::left << std::setw(28) << "benchmark" << std::right << std::setw(6) << "runs"
+        << std::setw(14) << "median ms" << std::setw(14) << "min ms" << std::setw(16) << "items/s" << "\n";
+    for (const Benchmark& bench : makeBenchmarks(fixture)) {
+        if (bench.name.find(filter) == std::string::npos) continue;
+        Result r = measure(bench, minSeconds, minRuns);
+        std::cout << std::left << std::setw(28) << r.name << std::right << std::setw(6) << r.seconds.size()
+            << std::fixed << std::setprecision(3)
+            << std::setw(14) << r.median() * 1000 << std::setw(14) << r.seconds.front() * 1000
+            << std::setprecision(0) << std::setw(16) << r.items / r.median() << std::endl;
+        results.push_back(std::move(r));
+    }
+    fixture.cleanup();
+
+    if (!json.empty() && !writeJson(json, label, options, results)) return 1;
+    return 0;
+}
@@ -0,0 +1,151 @@
+#include "datagen.h"
+
+#include <charconv>
+
+#include "fileio.h"
+
+namespace MyLibrary
+{
+    namespace
+    {
+        const char* const kVerbs[] = {
+            "Call", "Email", "Review", "Write", "Plan", "Fix", "Update", "Book",
+            "Pay", "Prepare", "Schedule", "Buy", "Clean", "Read", "Submit", "Follow up on"
+        };
+        const char* const kObjects[] = {
+            "the quarterly report", "dentist appointment", "invoice", "pull request",
+            "team meeting", "the budget", "groceries", "car service", "tax return",
+            "slides", "release notes", "flight", "insurance renewal", "the backlog",
+            "design doc", "customer feedback", "onboarding checklist", "server upgrade"
+        };
+        const char* const kPeople[] = {
+            "Alice", "Bob", "Carol", "Dave", "Erin", "Frank", "Grace", "Heidi"
+        };
+
+        template <typename T, size_t N>
+        constexpr size_t countOf(T (&)[N]) { return N; }
+
+        const time_t kDay = 24 * 60 * 60;
+        // Matches the header TaskList writes; the rows follow its format
+        const char* const kHeader = "#todo-tasks v2";
+        const size_t kFlushBytes = 1 << 20;
+
+        void appendNumber(std::string& out, long long value) {
+            char number[24];
+            auto result = std::to_chars(number, number + sizeof(number), value);
+            out.append(number, static_cast<size_t>(result.ptr - number));
+        }
+    }
+
+    DatasetGenerator::DatasetGenerator(const DatasetOptions& options)
+        : state(options.seed)
+    {
+        time_t now = options.now != 0 ? options.now : std::time(nullptr);
+        today = now - now % kDay + kDay / 2;
+    }
+
+    uint64_t DatasetGenerator::random() {
+        // splitmix64: small, fast and the same everywhere, unlike the
+        // <random> distributions
+        uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    void DatasetGenerator::next(int& id, std::string& description, Priority& prio, bool& completed, time_t& due) {
+        id = nextId++;
+
+        description.clear();
+        const char* verb = kVerbs[below(countOf(kVerbs))];
+        const char* object = kObjects[below(countOf(kObjects))];
+        size_t form = below(4);
+        description += verb;
+        description += ' ';
+        if (form == 0) {
+            description += kPeople[below(countOf(kPeople))];
+            description += " about ";
+        }
+        description += object;
+        if (form == 1) {
+            description += " #";
+            appendNumber(description, static_cast<long long>(1 + below(9999)));
+        }
+
+        // 10% highest, 25% high, 35% medium, 20% low, 10% lowest
+        size_t p = below(100);
+        prio = p < 10 ? HIGHEST : p < 35 ? HIGH : p < 70 ? MEDIUM : p < 90 ? LOW : LOWEST;
+
+        // A fifth have no due date; the rest are mostly in the coming month,
+        // with a tail of overdue and far-off ones
+        size_t spread = below(100);
+        if (spread < 20) {
+            due = 0;
+            completed = below(100) < 35;
+        }
+        else if (spread < 45) {
+            due = today - static_cast<time_t>(1 + below(90)) * kDay;
+            completed = below(100) < 70;
+        }
+        else {
+            size_t days = spread < 85 ? below(30) : 30 + below(335);
+            due = today + static_cast<time_t>(days) * kDay;
+            completed = below(100) < 10;
+        }
+    }
+
+    bool writeDataset(const std::string& path, const DatasetOptions& options) {
+        AtomicFileWriter out;
+        if (!out.open(path)) {
+            std::cerr << "Error: Unable to open " << path << " for writing.\n";
+            return false;
+        }
+        std::string buffer = kHeader;
+        buffer += " next=";
+        appendNumber(buffer, static_cast<long long>(options.tasks + 1));
+        buffer += '\n';
+
+        DatasetGenerator generator(options);
+        std::string description;
+        for (size_t i = 0; i < options.tasks; ++i) {
+            int id;
+            Priority prio;
+            bool completed;
+            time_t due;
+            generator.next(id, description, prio, completed, due);
+            appendNumber(buffer, id);
+            buffer += '|';
+            buffer += description;
+            buffer += '|';
+            appendNumber(buffer, static_cast<int>(prio));
+            buffer += completed ? " 1 " : " 0 ";
+            appendNumber(buffer, static_cast<long long>(due));
+            buffer += '\n';
+            if (buffer.size() >= kFlushBytes) {
+                out.write(buffer);
+                buffer.clear();
+            }
+        }
+        out.write(buffer);
+        if (!out.commit()) {
+            std::cerr << "Error: Failed to write " << path << ".\n";
+            return false;
+        }
+        return true;
+    }
+
+    void fillDataset(TaskList& list, const DatasetOptions& options) {
+        list.reserveTasks(options.tasks, options.tasks * 24);
+        DatasetGenerator generator(options);
+        std::string description;
+        for (size_t i = 0; i < options.tasks; ++i) {
+            int id;
+            Priority prio;
+            bool completed;
+            time_t due;
+            generator.next(id, description, prio, completed, due);
+            list.emplaceTask(description, prio, due, completed);
+        }
+    }
+
+} // end namespace MyLibrary
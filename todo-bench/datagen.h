@@ -0,0 +1,56 @@
+#pragma once
+#ifndef DATAGEN_H
+#define DATAGEN_H
+
+#include <string>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+
+#include "mylibrary.h"
+
+namespace MyLibrary
+{
+    struct DatasetOptions {
+        size_t tasks = 1000000;
+        uint64_t seed = 1;
+        time_t now = 0;  // due dates are spread around this; 0 = current time
+    };
+
+    /**
+     * Synthetic task lists that look like real ones: most tasks are
+     * medium or high priority, a fifth have no due date, overdue tasks
+     * are mostly completed and future ones mostly pending, and
+     * descriptions are built from a small vocabulary so they repeat the
+     * way real lists do ("Call Bob about the budget", "Pay invoice #212").
+     *
+     * Rows depend only on the options: the generator has its own PRNG,
+     * so every platform and compiler produces the same file.
+     */
+    class DatasetGenerator {
+    public:
+        explicit DatasetGenerator(const DatasetOptions& options);
+
+        // Fill in the next row; IDs run from 1
+        void next(int& id, std::string& description, Priority& prio, bool& completed, time_t& due);
+        // The underlying stream, for callers that need more of the same
+        uint64_t random();
+
+    private:
+        size_t below(size_t n) { return static_cast<size_t>(random() % n); }
+
+        uint64_t state;
+        time_t today;  // noon (UTC) of the day containing options.now
+        int nextId = 1;
+    };
+
+    // Stream a text-format tasks file (what saveTasksToFile writes) with
+    // options.tasks rows; only one row is held at a time
+    bool writeDataset(const std::string& path, const DatasetOptions& options);
+
+    // Add the same rows to list, which should be empty
+    void fillDataset(TaskList& list, const DatasetOptions& options);
+
+} // end namespace MyLibrary
+
+#endif // DATAGEN_H
@@ -0,0 +1,112 @@
+#include "testing.h"
+#include "taskcompress.h"
+
+#include <cstdint>
+
+using namespace MyLibrary;
+
+namespace
+{
+    // Same sequence on every platform, unlike std::rand
+    class TestRandom {
+    public:
+        explicit TestRandom(uint64_t seed) : state(seed) {}
+        uint64_t next() {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            return state;
+        }
+
+    private:
+        uint64_t state;
+    };
+
+    std::string compress(const std::string& raw) {
+        std::string packed(compressBound(raw.size()), '\0');
+        packed.resize(compressBlock(raw.data(), raw.size(), &packed[0]));
+        return packed;
+    }
+
+    bool decompress(const std::string& packed, size_t rawSize, std::string& raw) {
+        // One spare byte so an empty block still has a buffer to point at
+        raw.assign(rawSize + 1, '\0');
+        bool ok = decompressBlock(packed.data(), packed.size(), &raw[0], rawSize);
+        raw.resize(rawSize);
+        return ok;
+    }
+
+    std::vector<std::string> sampleInputs() {
+        std::vector<std::string> inputs = { "", "a", "abcabcabcabcabcabcabc", std::string(100000, 'x') };
+        std::string text;
+        for (int i = 0; i < 5000; ++i) text += "Call Bob about invoice #" + std::to_string(i % 37) + "\n";
+        inputs.push_back(text);
+        TestRandom random(7);
+        std::string noise(70000, '\0');
+        for (char& c : noise) c = static_cast<char>(random.next());
+        inputs.push_back(noise);
+        // Matches further back than the 64KB window can reach
+        inputs.push_back(noise + noise);
+        return inputs;
+    }
+}
+
+TODO_TEST(compressRoundTrip) {
+    for (const std::string& input : sampleInputs()) {
+        std::string packed = compress(input);
+        TODO_CHECK(packed.size() <= compressBound(input.size()));
+        std::string raw;
+        TODO_CHECK(decompress(packed, input.size(), raw));
+        TODO_CHECK(raw == input);
+    }
+}
+
+TODO_TEST(compressShrinksRepetitiveText) {
+    std::string text;
+    for (int i = 0; i < 2000; ++i) text += "Water the plants|3 0 1756728000\n";
+    TODO_CHECK(compress(text).size() < text.size() / 10);
+}
+
+TODO_TEST(decompressRejectsWrongSize) {
+    std::string input = sampleInputs()[4];
+    std::string packed = compress(input);
+    std::string raw;
+    TODO_CHECK(!decompress(packed, input.size() - 1, raw));
+    TODO_CHECK(!decompress(packed, input.size() + 1, raw));
+}
+
+TODO_TEST(decompressRejectsTruncatedInput) {
+    for (const std::string& input : sampleInputs()) {
+        if (input.empty()) continue;
+        std::string packed = compress(input);
+        std::string raw;
+        for (size_t cut = 0; cut < packed.size(); cut += 1 + packed.size() / 200) {
+            TODO_CHECK(!decompress(packed.substr(0, cut), input.size(), raw));
+        }
+    }
+}
+
+TODO_TEST(decompressSurvivesCorruptInput) {
+    // Garbage may decode to garbage, but must never touch memory outside
+    // the buffers (run under a sanitizer or the debug CRT to see that)
+    TestRandom random(11);
+    std::vector<std::string> inputs = sampleInputs();
+    for (int round = 0; round < 3000; ++round) {
+        const std::string& input = inputs[1 + random.next() % (inputs.size() - 1)];
+        std::string packed = compress(input);
+        int flips = 1 + static_cast<int>(random.next() % 4);
+        for (int i = 0; i < flips; ++i) {
+            packed[random.next() % packed.size()] ^= static_cast<char>(1 + random.next() % 255);
+        }
+        std::string raw;
+        decompress(packed, input.size(), raw);
+        TODO_CHECK_EQ(raw.size(), input.size());
+    }
+    // Pure noise as compressed input
+    for (int round = 0; round < 500; ++round) {
+        std::string packed(1 + random.next() % 512, '\0');
+        for (char& c : packed) c = static_cast<char>(random.next());
+        std::string raw;
+        decompress(packed, static_cast<size_t>(random.next() % 4096), raw);
+    }
+}
@@ -0,0 +1,249 @@
+#include "testing.h"
+
+#include <filesystem>
+
+using namespace MyLibrary;
+namespace fs = std::filesystem;
+
+namespace
+{
+    /*
+     * A crash is simulated by copying the journal aside while the list
+     * still has it open (after syncJournal, so the records are on disk),
+     * then letting the list close normally and putting the copy back.
+     */
+    struct JournalFiles {
+        explicit JournalFiles(const TempDir& dir)
+            : journal(dir.file("tasks.journal")), old(journal + ".old"), snapshot(dir.file("tasks.snap"))
+        {}
+
+        std::string journal;
+        std::string old;
+        std::string snapshot;
+    };
+
+    void copyOver(const std::string& from, const std::string& to) {
+        fs::copy_file(from, to, fs::copy_options::overwrite_existing);
+    }
+
+    // What main does on start-up in journal mode
+    void openLikeMain(TaskList& list, const JournalFiles& files) {
+        list.loadTasksFromSnapshot(files.snapshot);
+        TODO_CHECK(list.openJournal(files.journal, files.snapshot));
+    }
+}
+
+TODO_TEST(journalReplaysChanges) {
+    TempDir dir;
+    JournalFiles files(dir);
+    TempDir crash;
+    std::string expected;
+    {
+        TaskList list;
+        openLikeMain(list, files);
+        list.emplaceTask("first", HIGH, 1756728000);
+        list.emplaceTask("second", LOW, 0);
+        list.emplaceTask("third", MEDIUM, 0);
+        list.updateTask(1, std::string_view("first, edited"), HIGHEST, true, time_t(0));
+        list.deleteTask(2);
+        list.setDeleteMode(DELETE_SWAP);
+        list.emplaceTask("fourth", LOWEST, 0);
+        list.deleteTask(1);
+        list.syncJournal();
+        expected = dumpTasks(list);
+        copyOver(files.journal, crash.file("tasks.journal"));
+    }
+    copyOver(crash.file("tasks.journal"), files.journal);
+    fs::remove(files.snapshot);
+
+    TaskList list;
+    list.setDeleteMode(DELETE_SWAP);
+    openLikeMain(list, files);
+    TODO_CHECK_EQ(dumpTasks(list), expected);
+    TODO_CHECK_EQ(list.emplaceTask("next", HIGH, 0), 5);
+}
+
+TODO_TEST(journalCloseFoldsIntoSnapshot) {
+    TempDir dir;
+    JournalFiles files(dir);
+    std::string expected;
+    {
+        TaskList list;
+        openLikeMain(list, files);
+        list.emplaceTask("kept", HIGH, 0);
+        expected = dumpTasks(list);
+        list.closeJournal();
+    }
+    TODO_CHECK(!fs::exists(files.journal));
+    TODO_CHECK(!fs::exists(files.old));
+
+    TaskList list;
+    list.loadTasksFromSnapshot(files.snapshot);
+    TODO_CHECK_EQ(dumpTasks(list), expected);
+}
+
+TODO_TEST(journalDropsTornTail) {
+    TempDir dir;
+    JournalFiles files(dir);
+    TempDir crash;
+    {
+        TaskList list;
+        openLikeMain(list, files);
+        list.emplaceTask("one", HIGH, 0);
+        list.emplaceTask("two", HIGH, 0);
+        list.emplaceTask("three, cut short by the crash", HIGH, 0);
+        list.syncJournal();
+        copyOver(files.journal, crash.file("tasks.journal"));
+    }
+    // Lose the last few bytes, as a write cut off by power loss would
+    std::string torn = readFile(crash.file("tasks.journal"));
+    writeFile(files.journal, torn.substr(0, torn.size() - 5));
+    fs::remove(files.snapshot);
+
+    std::string expected;
+    {
+        TaskList list;
+        openLikeMain(list, files);
+        TODO_CHECK_EQ(dumpTasks(list), std::string("1|one|2 0 0\n2|two|2 0 0\n"));
+        // The torn record is cut off, so new records follow intact ones
+        TODO_CHECK(fs::file_size(files.journal) < torn.size() - 5);
+        TODO_CHECK_EQ(list.emplaceTask("after", LOW, 0), 3);
+        list.syncJournal();
+        expected = dumpTasks(list);
+        copyOver(files.journal, crash.file("tasks.journal"));
+    }
+    copyOver(crash.file("tasks.journal"), files.journal);
+    fs::remove(files.snapshot);
+
+    TaskList list;
+    openLikeMain(list, files);
+    TODO_CHECK_EQ(dumpTasks(list), expected);
+}
+
+TODO_TEST(journalFinishesInterruptedCompaction) {
+    // Compaction renames the journal to .old, logs into a fresh one and
+    // writes the snapshot; a crash before the snapshot lands leaves both
+    // journals. Build that state: .old with seq 1-2, the journal with 3-4.
+    TempDir dir;
+    JournalFiles files(dir);
+    TempDir crash;
+    {
+        TaskList list;
+        openLikeMain(list, files);
+        list.emplaceTask("one", HIGH, 0);
+        list.emplaceTask("two", HIGH, 0);
+        list.syncJournal();
+        copyOver(files.journal, crash.file("tasks.journal"));
+    }
+    fs::remove(files.snapshot);
+    copyOver(crash.file("tasks.journal"), files.old);
+    {
+        // Append-only mode continues the sequence from .old and leaves
+        // both files alone on close
+        TaskList list;
+        TODO_CHECK(list.openJournalForAppend(files.journal, files.snapshot));
+        list.emplaceTask("three", LOW, 0);
+        list.updateTask(1, {}, {}, true, {});
+        list.closeJournal();
+    }
+    TODO_CHECK(fs::exists(files.old));
+    TODO_CHECK(fs::exists(files.journal));
+
+    const std::string expected = "1|one|2 1 0\n2|two|2 0 0\n3|three|4 0 0\n";
+    {
+        TaskList list;
+        openLikeMain(list, files);
+        TODO_CHECK_EQ(dumpTasks(list), expected);
+        // Both journals are folded into the snapshot before logging goes on
+        TODO_CHECK(!fs::exists(files.old));
+        TODO_CHECK(fs::exists(files.snapshot));
+        list.syncJournal();
+        copyOver(files.journal, crash.file("tasks.journal"));
+    }
+    copyOver(crash.file("tasks.journal"), files.journal);
+
+    TaskList list;
+    openLikeMain(list, files);
+    TODO_CHECK_EQ(dumpTasks(list), expected);
+}
+
+TODO_TEST(journalCompactsInBackground) {
+    TempDir dir;
+    JournalFiles files(dir);
+    std::string expected;
+    {
+        TaskList list;
+        list.loadTasksFromSnapshot(files.snapshot);
+        TODO_CHECK(list.openJournal(files.journal, files.snapshot, 4096));
+        for (int i = 0; i < 3000; ++i) {
+            list.emplaceTask("task " + std::to_string(i), static_cast<Priority>(1 + i % 5), 0);
+            if (i % 3 == 0) list.deleteTask(i / 2 + 1);
+        }
+        expected = dumpTasks(list);
+        list.closeJournal();
+    }
+    TaskList list;
+    openLikeMain(list, files);
+    TODO_CHECK_EQ(list.count(), static_cast<size_t>(2000));
+    TODO_CHECK(dumpTasks(list) == expected);
+}
+
+TODO_TEST(journalKeepsTaskWhoseIdWasHandedOutAgain) {
+    // A run without the journal gave ID 1 to another task before the
+    // journal's add of ID 1 was replayed; the task on file must survive
+    TempDir dir;
+    JournalFiles files(dir);
+    TempDir crash;
+    {
+        TaskList list;
+        openLikeMain(list, files);
+        list.emplaceTask("from the journal", LOW, 0);
+        list.syncJournal();
+        copyOver(files.journal, crash.file("tasks.journal"));
+    }
+    fs::remove(files.snapshot);
+    copyOver(crash.file("tasks.journal"), files.journal);
+    writeFile(dir.file("tasks.txt"), "#todo-tasks v2 next=2\n1|from the text file|2 0 0\n");
+
+    TaskList list;
+    list.loadTasksFromFile(dir.file("tasks.txt"));
+    TODO_CHECK(list.openJournal(files.journal, files.snapshot));
+    TODO_CHECK_EQ(dumpTasks(list), std::string("1|from the text file|2 0 0\n"));
+    TODO_CHECK_EQ(list.emplaceTask("next", HIGH, 0), 2);
+}
+
+TODO_TEST(journalBatchIsOneRecordSet) {
+    TempDir dir;
+    JournalFiles files(dir);
+    TempDir crash;
+    std::string expected;
+    {
+        TaskList list;
+        openLikeMain(list, files);
+        Mutation add;
+        add.op = MUTATION_ADD;
+        add.description = std::string_view("batched");
+        add.priority = HIGH;
+        Mutation done;
+        done.op = MUTATION_COMPLETE;
+        done.id = 1;
+        Mutation missing;
+        missing.op = MUTATION_DELETE;
+        missing.id = 42;
+        std::vector<MutationResult> results = list.applyBatch({ add, done, missing });
+        TODO_CHECK_EQ(results.size(), static_cast<size_t>(3));
+        TODO_CHECK(results[0].status == MUTATION_OK && results[0].id == 1);
+        TODO_CHECK(results[1].status == MUTATION_OK);
+        TODO_CHECK(results[2].status != MUTATION_OK);
+        list.syncJournal();
+        expected = dumpTasks(list);
+        copyOver(files.journal, crash.file("tasks.journal"));
+    }
+    copyOver(crash.file("tasks.journal"), files.journal);
+    fs::remove(files.snapshot);
+
+    TaskList list;
+    openLikeMain(list, files);
+    TODO_CHECK_EQ(dumpTasks(list), expected);
+    TODO_CHECK_EQ(expected, std::string("1|batched|2 1 0\n"));
+}
@@ -0,0 +1,185 @@
+#include "testing.h"
+
+#include <algorithm>
+#include <thread>
+
+using namespace MyLibrary;
+
+namespace
+{
+    const time_t kNow = 1756728000;
+
+    // Every fifth task has no due date; the rest are spread around kNow
+    void fillDated(TaskList& list, int count) {
+        for (int i = 0; i < count; ++i) {
+            time_t due = i % 5 == 0 ? 0 : kNow + static_cast<time_t>((i % 11) - 5) * 3600;
+            list.emplaceTask("task " + std::to_string(i), static_cast<Priority>(1 + i % 5), due, i % 4 == 0);
+        }
+    }
+
+    size_t countOverdueByHand(TaskList& list) {
+        size_t overdue = 0;
+        for (size_t i = 0; i < list.count(); ++i) {
+            Task task = list.at(i);
+            if (!task.isCompleted() && task.getDueDate() != 0 && task.getDueDate() < kNow) ++overdue;
+        }
+        return overdue;
+    }
+}
+
+TODO_TEST(queryChainOnTemporary) {
+    // The documented form: the whole chain is the range of the loop
+    TaskList list;
+    fillDated(list, 300);
+    std::vector<int> ids;
+    for (size_t slot : list.query().pending().priorityAtMost(HIGH).orderBy(ORDER_PRIORITY).limit(20)) {
+        ids.push_back(list.at(slot).getId());
+    }
+    TODO_CHECK_EQ(ids.size(), static_cast<size_t>(20));
+    for (size_t i = 1; i < ids.size(); ++i) {
+        Task previous = *list.find(ids[i - 1]);
+        Task current = *list.find(ids[i]);
+        TODO_CHECK(previous.getPriority() < current.getPriority()
+            || (previous.getPriority() == current.getPriority() && previous.getId() < current.getId()));
+        TODO_CHECK(!current.isCompleted() && current.getPriority() <= HIGH);
+    }
+}
+
+TODO_TEST(queryPathsAgree) {
+    // Kernel path (slots, count), ordered walks and matches() on every slot
+    TaskList list;
+    fillDated(list, 5000);
+    TaskQuery query = list.query();
+    query.pending().priorityAtLeast(MEDIUM).dueFrom(kNow - 3 * 3600).dueBefore(kNow + 2 * 3600);
+    std::vector<size_t> expected;
+    for (size_t slot = 0; slot < list.count(); ++slot) {
+        if (query.matches(slot)) expected.push_back(slot);
+    }
+    TODO_CHECK(!expected.empty());
+    TODO_CHECK(query.slots() == expected);
+    TODO_CHECK_EQ(query.count(), expected.size());
+    for (QueryOrder order : { ORDER_PRIORITY, ORDER_DUE_DATE }) {
+        std::vector<size_t> walked = TaskQuery(query).orderBy(order, false).slots();
+        std::sort(walked.begin(), walked.end());
+        TODO_CHECK(walked == expected);
+    }
+}
+
+TODO_TEST(overdueLeavesOutUndatedTasks) {
+    // Stats, query and filter must agree on what "overdue" means
+    TaskList list;
+    fillDated(list, 1000);
+    size_t overdue = countOverdueByHand(list);
+    TODO_CHECK(overdue > 0);
+    TODO_CHECK_EQ(list.getStats(kNow).overdue, overdue);
+    TODO_CHECK_EQ(list.query().pending().dueBefore(kNow).count(), overdue);
+    size_t walked = 0;
+    for (size_t slot : list.query().pending().dueBefore(kNow).orderBy(ORDER_DUE_DATE)) {
+        TODO_CHECK(list.at(slot).getDueDate() != 0);
+        ++walked;
+    }
+    TODO_CHECK_EQ(walked, overdue);
+
+    TaskFilter filter;
+    filter.completed = false;
+    filter.dueBefore = kNow;
+    TODO_CHECK_EQ(list.countMatching(filter), overdue);
+
+    // Clearing a date takes the task out of the count
+    list.updateTask(2, {}, {}, false, time_t(kNow - 1));
+    TODO_CHECK_EQ(list.getStats(kNow).overdue, countOverdueByHand(list));
+    list.updateTask(2, {}, {}, {}, time_t(0));
+    TODO_CHECK_EQ(list.getStats(kNow).overdue, countOverdueByHand(list));
+    TODO_CHECK_EQ(list.countMatching(filter), countOverdueByHand(list));
+}
+
+TODO_TEST(remindersFireOncePerDueDate) {
+    TaskList list;
+    int a = list.emplaceTask("a", HIGH, 100);
+    int b = list.emplaceTask("b", HIGH, 150);
+    list.emplaceTask("c", HIGH, 200);
+    list.emplaceTask("later", HIGH, 1000);
+    list.emplaceTask("undated", HIGH, 0);
+
+    std::vector<int> fired;
+    TODO_CHECK_EQ(list.fireReminders(300, [&](const Task& task) { fired.push_back(task.getId()); }),
+        static_cast<size_t>(3));
+    TODO_CHECK(fired == std::vector<int>({ 1, 2, 3 }));
+    TODO_CHECK_EQ(list.fireReminders(300, [&](const Task&) { TODO_CHECK(false); }), static_cast<size_t>(0));
+    TODO_CHECK_EQ(list.nextReminder(), time_t(1000));
+
+    // Moving the date or reopening a task arms it again
+    list.updateTask(a, {}, {}, {}, time_t(250));
+    list.updateTask(b, {}, {}, true, {});
+    list.updateTask(b, {}, {}, false, {});
+    fired.clear();
+    list.fireReminders(300, [&](const Task& task) { fired.push_back(task.getId()); });
+    TODO_CHECK(fired == std::vector<int>({ b, a }));
+}
+
+TODO_TEST(remindersRearmedByAnotherHandlerWait) {
+    // a's handler snoozes b (also due) to a time that is still due, and
+    // clears c's date: b fires on the next call only, c never
+    TaskList list;
+    int a = list.emplaceTask("a", HIGH, 100);
+    int b = list.emplaceTask("b", HIGH, 150);
+    int c = list.emplaceTask("c", HIGH, 200);
+    int seen[4] = {};
+    size_t fired = list.fireReminders(300, [&](const Task& task) {
+        ++seen[task.getId()];
+        if (task.getId() == a) {
+            list.updateTask(b, {}, {}, {}, time_t(120));
+            list.updateTask(c, {}, {}, {}, time_t(0));
+        }
+    });
+    TODO_CHECK_EQ(fired, static_cast<size_t>(1));
+    TODO_CHECK(seen[b] == 0 && seen[c] == 0);
+
+    fired = list.fireReminders(300, [&](const Task& task) { ++seen[task.getId()]; });
+    TODO_CHECK_EQ(fired, static_cast<size_t>(1));
+    TODO_CHECK(seen[a] == 1 && seen[b] == 1 && seen[c] == 0);
+    TODO_CHECK_EQ(list.fireReminders(300, [&](const Task&) { TODO_CHECK(false); }), static_cast<size_t>(0));
+}
+
+TODO_TEST(searchFindsWordsAndPrefixes) {
+    TaskList list;
+    list.emplaceTask("Call Bob about the budget", HIGH, 0);
+    list.emplaceTask("Pay the invoice", HIGH, 0);
+    list.emplaceTask("Budget review", HIGH, 0);
+    TODO_CHECK(list.searchTasks("budget") == std::vector<int>({ 1, 3 }));
+    TODO_CHECK(list.searchTasks("the bud*") == std::vector<int>({ 1 }));
+    list.updateTask(2, std::string_view("Pay the budget invoice"));
+    TODO_CHECK(list.searchTasks("budget") == std::vector<int>({ 1, 2, 3 }));
+    list.deleteTask(1);
+    TODO_CHECK(list.searchTasks("bud*") == std::vector<int>({ 2, 3 }));
+}
+
+TODO_TEST(concurrentStoreAddsFromManyThreads) {
+    ConcurrentTaskStore store(16);
+    const int perThread = 500;
+    std::vector<std::thread> writers;
+    for (int t = 0; t < 4; ++t) {
+        writers.emplace_back([&store, t]() {
+            for (int i = 0; i < perThread; ++i) {
+                int id = store.add("thread " + std::to_string(t), static_cast<uint8_t>(1 + i % 5), 0);
+                if (i % 10 == 0) store.update(id, {}, {}, true);
+                if (i % 25 == 0) store.remove(id);
+            }
+        });
+    }
+    // Readers never block, and every snapshot is internally consistent
+    for (int i = 0; i < 200; ++i) {
+        ConcurrentTaskStore::Snapshot snapshot = store.snapshot();
+        size_t rows = 0;
+        for (size_t s = 0; s < snapshot.shardCount(); ++s) rows += snapshot.shard(s).size();
+        TODO_CHECK_EQ(rows, snapshot.size());
+    }
+    for (std::thread& writer : writers) writer.join();
+
+    TODO_CHECK_EQ(store.size(), static_cast<size_t>(4 * (perThread - perThread / 25)));
+    TaskStore merged;
+    store.exportTo(merged);
+    TODO_CHECK_EQ(merged.size(), store.size());
+    for (size_t slot = 1; slot < merged.size(); ++slot) TODO_CHECK(merged.id(slot - 1) < merged.id(slot));
+    TODO_CHECK_EQ(store.stats().completed, static_cast<size_t>(4 * (perThread / 10 - perThread / 50)));
+}
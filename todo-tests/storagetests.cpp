@@ -0,0 +1,263 @@
+#include "testing.h"
+
+#include <cstring>
+
+using namespace MyLibrary;
+
+namespace
+{
+    // A small list that uses every column: all priorities, both states,
+    // undated and negative due dates, and repeated text
+    void fillSample(TaskList& list) {
+        list.emplaceTask("Call Bob", HIGHEST, 1756728000);
+        list.emplaceTask("Pay invoice #212", MEDIUM, 0);
+        list.emplaceTask("Tabs\tand  spaces ", LOWEST, 1756814400, true);
+        list.emplaceTask("Call Bob", LOW, -86400);
+        list.emplaceTask("#not a header", HIGH, 1756900800);
+        list.deleteTask(2);
+        list.emplaceTask("Water the plants", MEDIUM, 1757000000, true);
+    }
+
+    /*
+     * Snapshot versions 1 and 2 are no longer written, so they are built
+     * here from the layout in tasksnapshot.cpp: the header up to journalSeq
+     * (v2: including it), then dueDate, id, descOffset[n + 1], priority,
+     * completed and the description bytes, each section 8-byte aligned.
+     */
+    struct LegacyRow {
+        int32_t id;
+        std::string description;
+        uint8_t priority;
+        bool completed;
+        int64_t dueDate;
+    };
+
+    size_t align8(size_t n) {
+        return (n + 7) & ~static_cast<size_t>(7);
+    }
+
+    template <typename T>
+    void put(std::string& out, size_t at, T value) {
+        std::memcpy(&out[at], &value, sizeof(value));
+    }
+
+    std::string legacySnapshot(uint32_t version, int32_t nextId, uint64_t journalSeq,
+        const std::vector<LegacyRow>& rows)
+    {
+        size_t n = rows.size();
+        size_t headerSize = version == 1 ? 40 : 48;
+        size_t blobSize = 0;
+        for (const LegacyRow& row : rows) blobSize += row.description.size();
+        size_t dueDates = align8(headerSize);
+        size_t ids = align8(dueDates + n * 8);
+        size_t offsets = align8(ids + n * 4);
+        size_t priorities = align8(offsets + (n + 1) * 4);
+        size_t completed = align8(priorities + n);
+        size_t blob = align8(completed + n);
+
+        std::string out(blob + blobSize, '\0');
+        std::memcpy(&out[0], "TODOSNAP", 8);
+        put(out, 8, version);
+        put(out, 12, static_cast<uint32_t>(headerSize));
+        put(out, 16, static_cast<uint64_t>(n));
+        put(out, 24, nextId);
+        put(out, 32, static_cast<uint64_t>(blobSize));
+        if (version >= 2) put(out, 40, journalSeq);
+        uint32_t offset = 0;
+        for (size_t i = 0; i < n; ++i) {
+            const LegacyRow& row = rows[i];
+            put(out, dueDates + i * 8, row.dueDate);
+            put(out, ids + i * 4, row.id);
+            put(out, offsets + i * 4, offset);
+            out[priorities + i] = static_cast<char>(row.priority);
+            out[completed + i] = row.completed ? 1 : 0;
+            std::memcpy(&out[blob + offset], row.description.data(), row.description.size());
+            offset += static_cast<uint32_t>(row.description.size());
+        }
+        put(out, offsets + n * 4, offset);
+        return out;
+    }
+
+    const std::vector<LegacyRow> kLegacyRows = {
+        { 3, "Call Bob", 2, false, 1756728000 },
+        { 7, "a|b", 5, true, 0 },
+        { 9, "Call Bob", 1, false, -3600 },
+    };
+    const char* const kLegacyDump =
+        "3|Call Bob|2 0 1756728000\n"
+        "7|a|b|5 1 0\n"
+        "9|Call Bob|1 0 -3600\n";
+}
+
+TODO_TEST(textFileRoundTrip) {
+    TempDir dir;
+    TaskList list;
+    fillSample(list);
+    list.saveTasksToFile(dir.file("tasks.txt"));
+
+    TaskList loaded;
+    loaded.loadTasksFromFile(dir.file("tasks.txt"));
+    TODO_CHECK_EQ(dumpTasks(loaded), dumpTasks(list));
+    // The ID counter comes back too: deleted IDs are not handed out again
+    TODO_CHECK_EQ(loaded.emplaceTask("next", HIGH, 0), 7);
+}
+
+TODO_TEST(textFileRoundTripInterned) {
+    TempDir dir;
+    TaskList list;
+    list.setDescriptionInterning(true);
+    fillSample(list);
+    list.saveTasksToFile(dir.file("tasks.txt"));
+
+    TaskList loaded;
+    loaded.setDescriptionInterning(true);
+    loaded.loadTasksFromFile(dir.file("tasks.txt"));
+    TODO_CHECK_EQ(dumpTasks(loaded), dumpTasks(list));
+}
+
+TODO_TEST(textFileBackgroundSave) {
+    TempDir dir;
+    TaskList list;
+    fillSample(list);
+    std::string expected = dumpTasks(list);
+    std::shared_future<bool> saved = list.saveTasksToFileAsync(dir.file("tasks.txt"));
+    // Edits after the save started do not reach it
+    list.emplaceTask("too late", HIGH, 0);
+    TODO_CHECK(saved.get());
+
+    TaskList loaded;
+    loaded.loadTasksFromFile(dir.file("tasks.txt"));
+    TODO_CHECK_EQ(dumpTasks(loaded), expected);
+}
+
+TODO_TEST(textFileLegacyRows) {
+    // Before the header and IDs, rows were "description|priority completed due";
+    // a first row starting with '#' is still a task, not a header
+    TempDir dir;
+    writeFile(dir.file("tasks.txt"), "#1 priority|1 0 0\nSecond|3 1 1756728000\n");
+    TaskList list;
+    list.loadTasksFromFile(dir.file("tasks.txt"));
+    TODO_CHECK_EQ(dumpTasks(list), std::string("1|#1 priority|1 0 0\n2|Second|3 1 1756728000\n"));
+}
+
+TODO_TEST(textFileKeepsBarsInDescriptions) {
+    // New descriptions cannot contain '|', but files written before that
+    // rule may; the numbers follow the last '|' of the row
+    TempDir dir;
+    writeFile(dir.file("tasks.txt"), "#todo-tasks v2 next=3\n1|a|b | c|5 1 1756814400\n2|x||2 0 0\n");
+    TaskList list;
+    list.loadTasksFromFile(dir.file("tasks.txt"));
+    TODO_CHECK_EQ(dumpTasks(list), std::string("1|a|b | c|5 1 1756814400\n2|x||2 0 0\n"));
+}
+
+TODO_TEST(textFileSkipsBadRows) {
+    TempDir dir;
+    writeFile(dir.file("tasks.txt"),
+        "#todo-tasks v2 next=10\n"
+        "1|Good|2 0 0\n"
+        "2|Bad priority|9 0 0\n"
+        "x|No ID|2 0 0\n"
+        "1|Duplicate ID|2 0 0\n"
+        "4|Also good|5 1 1756728000\n");
+    TaskList list;
+    list.loadTasksFromFile(dir.file("tasks.txt"));
+    TODO_CHECK_EQ(dumpTasks(list), std::string("1|Good|2 0 0\n4|Also good|5 1 1756728000\n"));
+    TODO_CHECK_EQ(list.emplaceTask("next", HIGH, 0), 10);
+}
+
+TODO_TEST(textFileRejectsUnsavableDescriptions) {
+    TaskList list;
+    TODO_CHECK_EQ(list.emplaceTask("", HIGH, 0), 0);
+    TODO_CHECK_EQ(list.emplaceTask("two\nlines", HIGH, 0), 0);
+    TODO_CHECK_EQ(list.emplaceTask("carriage\rreturn", HIGH, 0), 0);
+    TODO_CHECK_EQ(list.emplaceTask("a|b", HIGH, 0), 0);
+    TODO_CHECK_EQ(list.emplaceTask("fine", static_cast<Priority>(6), 0), 0);
+    TODO_CHECK_EQ(list.emplaceTask("fine", HIGH, 0), 1);
+    TODO_CHECK_EQ(list.count(), static_cast<size_t>(1));
+}
+
+TODO_TEST(snapshotRoundTrip) {
+    for (bool compressed : { false, true }) {
+        for (bool interned : { false, true }) {
+            TempDir dir;
+            TaskList list;
+            list.setDescriptionInterning(interned);
+            list.setSnapshotCompression(compressed);
+            fillSample(list);
+            list.saveTasksToSnapshot(dir.file("tasks.snap"));
+
+            TaskList loaded;
+            loaded.loadTasksFromSnapshot(dir.file("tasks.snap"));
+            TODO_CHECK_EQ(dumpTasks(loaded), dumpTasks(list));
+            TODO_CHECK_EQ(loaded.emplaceTask("next", HIGH, 0), 7);
+        }
+    }
+}
+
+TODO_TEST(snapshotRoundTripManyBlocks) {
+    // More rows than one compressed block holds, with IDs and dates that
+    // jump both ways so the deltas go negative
+    TempDir dir;
+    TaskList list;
+    list.setSnapshotCompression(true);
+    for (int i = 0; i < 40000; ++i) {
+        std::string text = "task " + std::to_string(i % 97) + (i % 5 == 0 ? " with a longer tail" : "");
+        list.emplaceTask(text, static_cast<Priority>(1 + i % 5),
+            i % 7 == 0 ? 0 : static_cast<time_t>(1756728000 + (i % 13) * 86400 - (i % 3) * 400000), i % 4 == 0);
+    }
+    for (int id = 2; id < 40000; id += 3) list.deleteTask(id);
+    list.sortTasksByDueDate();
+    list.saveTasksToSnapshot(dir.file("tasks.snap"));
+
+    TaskList loaded;
+    loaded.loadTasksFromSnapshot(dir.file("tasks.snap"));
+    TODO_CHECK_EQ(loaded.count(), list.count());
+    TODO_CHECK(dumpTasks(loaded) == dumpTasks(list));
+}
+
+TODO_TEST(snapshotLegacyVersions) {
+    for (uint32_t version : { 1u, 2u }) {
+        TempDir dir;
+        writeFile(dir.file("tasks.snap"), legacySnapshot(version, 12, 5, kLegacyRows));
+        TaskList list;
+        list.loadTasksFromSnapshot(dir.file("tasks.snap"));
+        TODO_CHECK_EQ(dumpTasks(list), std::string(kLegacyDump));
+        TODO_CHECK_EQ(list.emplaceTask("next", HIGH, 0), 12);
+    }
+}
+
+TODO_TEST(snapshotRejectsCorruptFiles) {
+    TempDir dir;
+    for (bool compressed : { false, true }) {
+        TaskList source;
+        source.setSnapshotCompression(compressed);
+        fillSample(source);
+        source.saveTasksToSnapshot(dir.file("good.snap"));
+        std::string good = readFile(dir.file("good.snap"));
+        TODO_CHECK(good.size() > 64);
+
+        // A truncated file loads nothing and leaves the current tasks alone
+        for (size_t cut : { size_t(4), size_t(40), good.size() / 2, good.size() - 1 }) {
+            writeFile(dir.file("bad.snap"), good.substr(0, cut));
+            TaskList list;
+            list.emplaceTask("kept", HIGH, 0);
+            list.loadTasksFromSnapshot(dir.file("bad.snap"));
+            TODO_CHECK_EQ(dumpTasks(list), std::string("1|kept|2 0 0\n"));
+        }
+
+        // Flipped bytes anywhere must not crash or read out of bounds;
+        // whatever does load has to be valid tasks
+        for (size_t at = 0; at < good.size(); ++at) {
+            std::string bad = good;
+            bad[at] = static_cast<char>(bad[at] ^ 0x5a);
+            writeFile(dir.file("bad.snap"), bad);
+            TaskList list;
+            list.loadTasksFromSnapshot(dir.file("bad.snap"));
+            for (size_t i = 0; i < list.count(); ++i) {
+                Task task = list.at(i);
+                TODO_CHECK(task.getId() > 0);
+                TODO_CHECK(task.getPriority() >= HIGHEST && task.getPriority() <= LOWEST);
+            }
+        }
+    }
+}
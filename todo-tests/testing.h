@@ -0,0 +1,82 @@
+#pragma once
+#ifndef TESTING_H
+#define TESTING_H
+
+#include <filesystem>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "mylibrary.h"
+
+namespace MyLibrary
+{
+    /*
+     * Just enough of a test runner for todo-tests: TODO_TEST defines and
+     * registers a test, TODO_CHECK records a failure and lets the test carry
+     * on. No dependencies, so the project builds wherever todo-app does.
+     */
+
+    struct TestCase {
+        const char* name;
+        void (*run)();
+    };
+
+    std::vector<TestCase>& testRegistry();
+
+    struct TestRegistrar {
+        TestRegistrar(const char* name, void (*run)()) { testRegistry().push_back({ name, run }); }
+    };
+
+    void recordFailure(const char* file, int line, const std::string& what);
+
+    /**
+     * Fresh empty directory under the temp directory, removed with
+     * everything in it when the object goes away.
+     */
+    class TempDir {
+    public:
+        TempDir();
+        ~TempDir();
+
+        TempDir(const TempDir&) = delete;
+        TempDir& operator=(const TempDir&) = delete;
+
+        std::string file(const char* name) const { return (path / name).string(); }
+
+    private:
+        std::filesystem::path path;
+    };
+
+    // Whole contents of a file; empty if it cannot be read
+    std::string readFile(const std::string& path);
+    void writeFile(const std::string& path, const std::string& data);
+
+    // "id|description|priority completed due" for every task, in display order
+    std::string dumpTasks(TaskList& list);
+
+} // end namespace MyLibrary
+
+#define TODO_TEST(name)                                                        \
+    static void name();                                                        \
+    static ::MyLibrary::TestRegistrar name##Registrar(#name, name);            \
+    static void name()
+
+#define TODO_CHECK(condition)                                                  \
+    do {                                                                       \
+        if (!(condition)) ::MyLibrary::recordFailure(__FILE__, __LINE__, #condition); \
+    } while (0)
+
+#define TODO_CHECK_EQ(actual, expected)                                        \
+    do {                                                                       \
+        const auto& todoActual = (actual);                                     \
+        const auto& todoExpected = (expected);                                 \
+        if (!(todoActual == todoExpected)) {                                   \
+            std::ostringstream todoWhat;                                       \
+            todoWhat << #actual << " == " << #expected << "\n    got:      "   \
+                << todoActual << "\n    expected: " << todoExpected;            \
+            ::MyLibrary::recordFailure(__FILE__, __LINE__, todoWhat.str());    \
+        }                                                                      \
+    } while (0)
+
+#endif // TESTING_H
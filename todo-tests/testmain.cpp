@@ -0,0 +1,95 @@
+#include "testing.h"
+
+#include <atomic>
+#include <fstream>
+#include <iostream>
+#include <streambuf>
+
+namespace MyLibrary
+{
+    namespace
+    {
+        int failures = 0;
+
+        // Listings are checked through the task views, not their text
+        class DiscardBuffer : public std::streambuf {
+        protected:
+            int overflow(int c) override { return c == traits_type::eof() ? 0 : c; }
+            std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+        };
+    }
+
+    std::vector<TestCase>& testRegistry() {
+        static std::vector<TestCase> tests;
+        return tests;
+    }
+
+    void recordFailure(const char* file, int line, const std::string& what) {
+        ++failures;
+        std::cerr << file << "(" << line << "): check failed: " << what << "\n";
+    }
+
+    TempDir::TempDir() {
+        static std::atomic<unsigned> made{ 0 };
+        std::filesystem::path base = std::filesystem::temp_directory_path();
+        std::string stem = "todo-tests-" + std::to_string(static_cast<unsigned long long>(std::time(nullptr)));
+        do {
+            path = base / (stem + "-" + std::to_string(++made));
+        } while (!std::filesystem::create_directory(path));
+    }
+
+    TempDir::~TempDir() {
+        std::error_code ec;
+        std::filesystem::remove_all(path, ec);
+    }
+
+    std::string readFile(const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    void writeFile(const std::string& path, const std::string& data) {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(data.data(), static_cast<std::streamsize>(data.size()));
+    }
+
+    std::string dumpTasks(TaskList& list) {
+        std::string out;
+        for (size_t i = 0; i < list.count(); ++i) {
+            Task task = list.at(i);
+            out += std::to_string(task.getId());
+            out += '|';
+            out += task.getDescription();
+            out += '|';
+            out += std::to_string(static_cast<int>(task.getPriority()));
+            out += task.isCompleted() ? " 1 " : " 0 ";
+            out += std::to_string(static_cast<long long>(task.getDueDate()));
+            out += '\n';
+        }
+        return out;
+    }
+
+} // end namespace MyLibrary
+
+int main(int argc, char* argv[]) {
+    using namespace MyLibrary;
+
+    // todo-tests [NAME...]: run the tests whose names contain any NAME
+    // (all of them by default); exits non-zero if a check failed
+    DiscardBuffer discard;
+    std::ostream quiet(&discard);
+    TaskList::defaultList().setOutput(quiet);
+
+    size_t ran = 0;
+    for (const TestCase& test : testRegistry()) {
+        bool wanted = argc < 2;
+        for (int i = 1; i < argc && !wanted; ++i) wanted = std::string(test.name).find(argv[i]) != std::string::npos;
+        if (!wanted) continue;
+        int before = failures;
+        test.run();
+        ++ran;
+        std::cout << (failures == before ? "PASS " : "FAIL ") << test.name << std::endl;
+    }
+    std::cout << ran << " tests, " << failures << " failed checks.\n";
+    return failures == 0 ? 0 : 1;
+}